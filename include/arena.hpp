@@ -0,0 +1,41 @@
+#ifndef ARENA_H_9b47c15f853c5a1d
+#define ARENA_H_9b47c15f853c5a1d
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump-pointer allocator. Allocations are never freed one by one; reset()
+// or the destructor releases everything at once, so there is no per-object
+// header and no fragmentation.
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 1 << 20);
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+    template <typename T> T *allocateArray(size_t n) {
+        return static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // Frees everything; the first block is kept for reuse
+    void reset();
+
+    size_t bytesUsed() const;     // Handed out, including alignment padding
+    size_t bytesReserved() const; // Held from the system
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t used_;     // Offset into the current (last) block
+    size_t usedDone_; // Bytes used in the blocks before it
+};
+
+#endif // ARENA_H_9b47c15f853c5a1d
@@ -0,0 +1,62 @@
+#ifndef BATCH_SOLVER_H_9b47c15f853c5a1d
+#define BATCH_SOLVER_H_9b47c15f853c5a1d
+
+#include "solver.hpp"
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BatchConfig {
+    size_t threads = 1;
+    SolverLimits limits; // Budget of a level's first attempt
+    SolverOptions options;
+    size_t attempts = 3; // Tries per level, including the first
+    double growth = 4.0; // Time and memory budget factor per retry
+};
+
+struct BatchResult {
+    size_t index = 0; // Position in the input list
+    std::string file;
+    double difficulty = 0;
+    size_t attempts = 0;
+    SolverResult result;
+};
+
+// Solves a pack on a pool of threads, one level per thread at a time.
+// Levels are queued easiest first by estimateDifficulty(); a level that
+// runs out of time or memory goes back in the queue with a bigger budget,
+// behind every level still on its first attempt.
+class BatchSolver {
+public:
+    using Callback = std::function<void(const BatchResult &)>;
+
+    explicit BatchSolver(BatchConfig config);
+
+    // Calls report (never concurrently) as soon as a level's outcome is
+    // final. Returns every result in input order.
+    std::vector<BatchResult> run(const std::vector<std::string> &files,
+                                 const Callback &report = nullptr);
+
+private:
+    BatchConfig config_;
+};
+
+enum class ReportFormat { CSV, JSON };
+
+// Streams results as CSV with a header row, or as JSON Lines (one object
+// per level), flushing after each so a long run can be watched
+class ReportWriter {
+public:
+    ReportWriter(std::ostream &out, ReportFormat format);
+
+    void write(const BatchResult &result);
+
+private:
+    std::ostream &out_;
+    ReportFormat format_;
+    bool header_;
+};
+
+#endif // BATCH_SOLVER_H_9b47c15f853c5a1d
@@ -2,15 +2,30 @@
 #define BOARD_H_9b47c15f853c5a1d
 #include "types.hpp"
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
+#include <ostream>
 #include <string>
 #include <vector>
 
 using namespace Type;
 
+// What Board::normalize() found out about a level
+struct LevelCheck {
+    size_t players = 0;
+    size_t boxes = 0;
+    size_t goals = 0;
+    bool enclosed = false; // The player cannot walk off the board
+    std::vector<std::string> problems;
+    bool valid() const { return problems.empty(); }
+};
+
 class Board {
 public:
+    static constexpr uint32_t MaxSide = 4096; // Largest side a file may give
+
     static Board &instance();
+    Board(); // Standalone boards, e.g. one per server session
     void resize(size_t x, size_t y);         // Accepts (width, height)
     std::vector<Flag> &operator[](size_t i); // Access by row index
     const std::vector<Flag> &operator[](size_t i) const; // Access by row index
@@ -19,9 +34,14 @@ public:
     bool saveToFile(const std::string &filename) const;
     bool loadFromFile(const std::string &filename);
     void print() const;
+    void print(std::ostream &out) const;
+
+    // Validates a freshly loaded level and, if it is valid, clears
+    // everything outside the walls around the player's area to Empty and
+    // crops the board to that area. Invalid boards are left untouched.
+    LevelCheck normalize();
 
 private:
-    Board();
     std::vector<std::vector<Flag>> data_;
 };
 
@@ -0,0 +1,62 @@
+#ifndef BOARD_WIDGET_H_9b47c15f853c5a1d
+#define BOARD_WIDGET_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "game.hpp"
+#include "types.hpp"
+#include <QImage>
+#include <QRect>
+#include <QTimer>
+#include <QWidget>
+#include <array>
+#include <cstdint>
+
+class QPainter;
+
+// Software-rasterized view of the Board. Every tile is pre-drawn once into
+// an atlas QImage; painting is then a plain blit per visible cell, and a
+// move only invalidates the cells reported by Game::dirtyCells().
+// Key presses go through Game's input queue and are applied once per frame.
+class BoardWidget : public QWidget {
+public:
+    explicit BoardWidget(Game &game, QWidget *parent = nullptr);
+
+    // Repaint everything, e.g. after a new level was loaded
+    void refresh();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    enum Tile : uint8_t {
+        TileEmpty,
+        TileFloor,
+        TileWall,
+        TileGoal,
+        TileBox,
+        TileBoxOnGoal,
+        TilePlayer,
+        TilePlayerOnGoal,
+        TileCount
+    };
+
+    void tick(); // Drains queued input and schedules the dirty cells
+    void layout();
+    void buildAtlas();
+    void paintCells(QPainter &painter, const QRect &area) const;
+    QRect boardRect() const;
+    QRect cellRect(size_t x, size_t y) const;
+
+    Game &game_;
+    const Board &board_;
+    std::array<uint8_t, 256> tileOf_; // Flag -> atlas tile index
+    QImage atlas_;                    // TileCount tiles in a single row
+    int tileSize_;
+    int originX_; // Top-left pixel of the board inside the widget
+    int originY_;
+    QTimer frameTimer_;
+};
+
+#endif // BOARD_WIDGET_H_9b47c15f853c5a1d
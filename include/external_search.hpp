@@ -0,0 +1,109 @@
+#ifndef EXTERNAL_SEARCH_H_9b47c15f853c5a1d
+#define EXTERNAL_SEARCH_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "search_node.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Sorted fixed-size records on disk, front-coded: each record stores how
+// many leading bytes it shares with the previous one (varint), then the
+// rest. Sorted search states share long prefixes, so layers shrink a lot.
+class RecordWriter {
+public:
+    bool open(const std::string &path, size_t recordBytes,
+              size_t bufferBytes = 1 << 20);
+    void write(const uint8_t *record);
+    bool close(); // False if any write failed
+    size_t count() const;
+
+private:
+    std::ofstream out_;
+    std::vector<char> buffer_;
+    std::vector<uint8_t> previous_;
+    size_t recordBytes_ = 0;
+    size_t count_ = 0;
+};
+
+class RecordReader {
+public:
+    bool open(const std::string &path, size_t recordBytes,
+              size_t bufferBytes = 1 << 20);
+    bool next(uint8_t *record); // False at the end of the file or on bad()
+    const uint8_t *current() const;
+    bool bad() const; // The file ended inside a record or is corrupt
+
+private:
+    std::ifstream in_;
+    std::vector<char> buffer_;
+    std::vector<uint8_t> current_;
+    size_t recordBytes_ = 0;
+    bool bad_ = false;
+};
+
+struct ExternalSearchConfig {
+    std::string workDir;                 // Layers and checkpoints go here
+    size_t memoryBytes = size_t(256) << 20; // RAM for unsorted successors
+    size_t maxDepth = SIZE_MAX;          // Give up after this many pushes
+    bool resume = true; // Continue from a checkpoint in workDir if any
+};
+
+struct ExternalSearchResult {
+    bool solved = false;
+    bool exhausted = false; // Every reachable state seen, no solution
+    bool resumed = false;   // Started from a checkpoint
+    bool ioError = false;   // A work file is unreadable, damaged or unwritable
+    size_t depth = 0;       // Pushes in the solution, or layers finished
+    size_t states = 0;      // Distinct states visited
+    size_t runs = 0;        // Sorted runs spilled to disk
+    size_t diskBytes = 0;   // Size of the layer and visited files
+    std::string solution;   // LURD, push-optimal
+};
+
+// Breadth-first search over pushes with the frontier on disk. Each layer
+// is generated by streaming the previous one, spilling sorted runs of
+// successors whenever memoryBytes fill up, merging the runs (in several
+// passes when there are many) and dropping every state already in the
+// sorted visited file. After each layer a
+// checkpoint is written, and a later run with the same workDir and level
+// picks up from there.
+class ExternalSearch {
+public:
+    ExternalSearch(const Board &level, ExternalSearchConfig config);
+
+    ExternalSearchResult run();
+
+private:
+    struct Checkpoint {
+        size_t depth = 0;
+        size_t layerCount = 0;
+        size_t visitedCount = 0;
+        size_t runs = 0;
+    };
+
+    std::string path(const std::string &name) const;
+    std::string layerPath(size_t depth) const;
+    std::string visitedPath(size_t depth) const;
+    std::string runPath(size_t index) const;
+    bool loadCheckpoint(Checkpoint &cp) const;
+    bool saveCheckpoint(const Checkpoint &cp) const;
+    bool start(Checkpoint &cp);
+    bool expand(Checkpoint &cp, bool &solved, std::vector<uint8_t> &goal);
+    bool spillRun(std::vector<uint8_t> &buffer, size_t runIndex);
+    bool reconstruct(size_t depth, std::vector<uint8_t> goal,
+                     std::string &lurd);
+    void successors(const uint8_t *record, std::vector<uint8_t> &out,
+                    std::vector<Push> *pushes = nullptr) const;
+
+    Board level_;
+    Layout layout_;
+    ExternalSearchConfig config_;
+    size_t boxBytes_;
+    size_t recordBytes_; // Box bits, then the normalized player (3 bytes)
+    std::string levelId_;
+};
+
+#endif // EXTERNAL_SEARCH_H_9b47c15f853c5a1d
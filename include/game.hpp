@@ -2,21 +2,67 @@
 #define GAME_H_9b47c15f853c5a1d
 
 #include "board.hpp"
+#include "input_log.hpp"
+#include "input_queue.hpp"
 #include "types.hpp"
+#include <array>
 #include <chrono>
+#include <memory>
+#include <ostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 enum class GameState { MENU, PLAYING, PAUSED, LEVEL_COMPLETE, GAME_OVER, QUIT };
 
 enum class Direction { UP, DOWN, LEFT, RIGHT };
 
+// Time input events spent queued before processInput picked them up
+struct InputLatency {
+    size_t count = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+    // Bucket i counts events that waited less than 2^i microseconds
+    std::array<size_t, 32> histogram{};
+};
+
+// Time source of the game loop. The real one sleeps between frames; a
+// replay jumps ahead instead and feeds recorded input as time passes.
+class FrameClock {
+public:
+    virtual ~FrameClock() = default;
+    // Called at the start of every frame
+    virtual std::chrono::steady_clock::time_point now() = 0;
+    virtual void sleepUntil(std::chrono::steady_clock::time_point t) = 0;
+};
+
+// Real time spent in one frame of the game loop
+struct FrameCost {
+    std::chrono::nanoseconds update{0}; // Input, update and level check
+    std::chrono::nanoseconds render{0};
+};
+
 class Game {
 public:
+    static constexpr std::chrono::milliseconds FrameInterval{100};
+
     static Game &instance();
+    // Input::None games are driven only through movePlayer and friends and
+    // carry no InputQueue, e.g. one per server session
+    enum class Input { Queued, None };
+    // Plays on its own board, not the singleton
+    explicit Game(Board &board, Input input = Input::Queued);
+    ~Game() = default;
+
+    const Board &board() const; // The board this game plays on
 
     // Game state management
     bool initialize();
-    void run();
+    void run(); // Real time, drawing to std::cout
+    // The same loop on another clock and output; appends the cost of each
+    // frame to costs if given
+    void run(FrameClock &clock, std::ostream &out,
+             std::vector<FrameCost> *costs = nullptr);
     void pause();
     void resume();
     void quit();
@@ -28,12 +74,23 @@ public:
     // Player movement
     bool movePlayer(Direction dir);
 
+    // Cells (x, y) changed by movePlayer since the last clearDirtyCells(),
+    // so frontends can redraw just those instead of the whole board
+    const std::vector<std::pair<size_t, size_t>> &dirtyCells() const;
+    void clearDirtyCells();
+
     // Game loop control
     void update(double deltaTime);
     void render() const;
 
-    // Input handling
+    // Input handling: one producer thread pushes, the game loop drains
+    // everything queued so far on each processInput call
+    InputQueue &inputQueue(); // Input::Queued games only
     void processInput();
+    void processInput(std::chrono::steady_clock::time_point now);
+    const InputLatency &inputLatency() const;
+    // Appends every input processed from now on to log (nullptr stops)
+    void recordInputs(InputLog *log);
 
     // Testing helpers
     void updateStateFromBoard(); // For testing - just updates player position
@@ -41,7 +98,6 @@ public:
 
 private:
     Game();
-    ~Game() = default;
 
     // Game state
     GameState state_;
@@ -50,15 +106,24 @@ private:
     size_t playerY_;
     size_t numBoxes_;
     size_t numBoxesOnGoal_;
+    std::vector<std::pair<size_t, size_t>> dirtyCells_;
+
+    // Input
+    std::unique_ptr<InputQueue> inputQueue_; // Null for Input::None
+    InputLatency inputLatency_;
+    InputLog *inputLog_;
 
-    // Game loop timing
-    std::chrono::time_point<std::chrono::high_resolution_clock> lastFrameTime_;
+    // Game loop timing and output
+    std::chrono::steady_clock::time_point lastFrameTime_;
+    std::ostream *out_;
 
     // Utility functions
     bool tryMove(size_t fromX, size_t fromY, size_t toX, size_t toY);
     void findPlayer();
     void countBoxes();
     void updateGameState();
+    void handleCommand(Command command);
+    void recordLatency(std::chrono::nanoseconds waited);
 };
 
 #endif // GAME_H_9b47c15f853c5a1d
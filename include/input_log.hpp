@@ -0,0 +1,27 @@
+#ifndef INPUT_LOG_H_9b47c15f853c5a1d
+#define INPUT_LOG_H_9b47c15f853c5a1d
+
+#include "input_queue.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Inputs of a play session with the time each was pressed, counted from
+// the start of the recording, so the session can be replayed later
+struct InputLog {
+    struct Entry {
+        std::chrono::nanoseconds at{0};
+        Command command = Command::QUIT;
+    };
+
+    std::vector<Entry> entries;
+    std::chrono::steady_clock::time_point start; // Not saved
+
+    void record(const InputEvent &event);
+
+    // Text file: a header line, then "<nanoseconds> <u|d|l|r|p|q>" lines
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename);
+};
+
+#endif // INPUT_LOG_H_9b47c15f853c5a1d
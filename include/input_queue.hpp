@@ -0,0 +1,87 @@
+#ifndef INPUT_QUEUE_H_9b47c15f853c5a1d
+#define INPUT_QUEUE_H_9b47c15f853c5a1d
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// The movement commands mirror Direction so they convert with a cast
+enum class Command : uint8_t { UP, DOWN, LEFT, RIGHT, PAUSE, QUIT };
+
+// A single key press as seen by the input thread
+struct InputEvent {
+    Command command;
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+// Wait-free single-producer/single-consumer ring buffer. Exactly one thread
+// may push and exactly one (other) thread may pop/drain. Head and tail live
+// on separate cache lines and each side keeps a private copy of the other's
+// index, so the shared atomics are only touched when that copy runs out.
+template <typename T, size_t Capacity> class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false only if the queue is full; the caller
+    // decides whether to retry (the input thread does, so nothing is lost).
+    bool push(const T &item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == Capacity) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == Capacity)
+                return false;
+        }
+        slots_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool pop(T &item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+                return false;
+        }
+        item = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Hands every item available right now to fn and
+    // publishes the new head once for the whole batch. Returns the count.
+    template <typename Fn> size_t drain(Fn &&fn) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        for (size_t i = head; i != cachedTail_; ++i) {
+            fn(slots_[i & (Capacity - 1)]);
+        }
+        head_.store(cachedTail_, std::memory_order_release);
+        return cachedTail_ - head;
+    }
+
+    // Approximate when called concurrently with push/pop
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t CacheLine = 64;
+
+    alignas(CacheLine) std::atomic<size_t> head_{0}; // Next slot to read
+    size_t cachedTail_ = 0;                          // Consumer's view
+    alignas(CacheLine) std::atomic<size_t> tail_{0}; // Next slot to write
+    size_t cachedHead_ = 0;                          // Producer's view
+    alignas(CacheLine) std::array<T, Capacity> slots_{};
+};
+
+using InputQueue = SpscQueue<InputEvent, 1024>;
+
+#endif // INPUT_QUEUE_H_9b47c15f853c5a1d
@@ -0,0 +1,72 @@
+#ifndef LEVEL_ANALYSIS_H_9b47c15f853c5a1d
+#define LEVEL_ANALYSIS_H_9b47c15f853c5a1d
+
+#include "search_node.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Part of the floor behind a single entrance cell that holds goals and no
+// boxes at the start. Boxes go in one at a time, in fill order, each along
+// a push path worked out when the level is analyzed.
+struct GoalRoom {
+    uint32_t entrance;
+    std::vector<uint32_t> cells; // Without the entrance
+    std::vector<uint32_t> fillOrder;
+    // paths[k * 4 + d]: pushes taking a box that arrived on the entrance
+    // moving in direction d to fillOrder[k], with the first k goals full
+    std::vector<std::vector<Push>> paths;
+    std::vector<uint8_t> hasPath;
+};
+
+// Static structure of a level that lets a search (or a hint) treat
+// several pushes as one move:
+//  - tunnels: one cell wide corridors, where a box pushed along with the
+//    player behind it is pushed on until it comes out;
+//  - articulation cells, whose removal splits the floor;
+//  - goal rooms, which hang off an articulation cell and are filled in a
+//    fixed order straight from their entrance.
+// Macros prune the moves in between, so a search using them is no longer
+// guaranteed to find the fewest pushes.
+class LevelAnalysis {
+public:
+    // layout must outlive the analysis; startBoxes are the level's boxes
+    LevelAnalysis(const Layout &layout, const uint8_t *startBoxes);
+
+    // A box on cell moving along dir has walls on both sides
+    bool isTunnel(uint32_t cell, Direction dir) const;
+    bool isArticulation(uint32_t cell) const;
+    const std::vector<GoalRoom> &goalRooms() const;
+    size_t tunnelCount() const; // Cells in a tunnel in either direction
+    size_t articulationCount() const;
+
+    // Called after push has been applied to boxes. If the push starts a
+    // macro, makes the rest of its pushes on boxes, appends them to follow
+    // and returns the player's cell; otherwise returns push.box.
+    uint32_t extend(uint8_t *boxes, const Push &push,
+                    std::vector<Push> &follow) const;
+
+private:
+    void findArticulations();
+    void findGoalRooms(const uint8_t *startBoxes);
+    bool planRoom(GoalRoom &room) const;
+    bool roomReady(const GoalRoom &room, const uint8_t *boxes,
+                   size_t &filled) const;
+
+    const Layout &layout_;
+    std::vector<uint8_t> tunnel_; // Bit 0: vertical, bit 1: horizontal
+    std::vector<uint8_t> articulation_;
+    std::vector<GoalRoom> rooms_;
+    std::vector<uint32_t> entranceOf_; // Cell -> room it leads into, or None
+    std::vector<uint32_t> roomOf_;     // Cell -> room it is in, or None
+};
+
+// Pushes that take the box on `box` to `target` with every other box
+// fixed. The player starts on `player` and may only stand on cells marked
+// in `allowed`; the box stays on allowed cells too. Returns false if
+// there is no way.
+bool pushBoxTo(const Layout &layout, uint32_t player, const uint8_t *boxes,
+               uint32_t box, uint32_t target,
+               const std::vector<uint8_t> &allowed, std::vector<Push> &out);
+
+#endif // LEVEL_ANALYSIS_H_9b47c15f853c5a1d
@@ -0,0 +1,58 @@
+#ifndef LEVEL_HASH_H_9b47c15f853c5a1d
+#define LEVEL_HASH_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 128-bit identity of a level, equal for levels that only differ by
+// rotation, mirroring, exterior padding or where the player starts within
+// the area it can walk to. Also usable as a cache key.
+struct LevelHash {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool operator==(const LevelHash &other) const = default;
+    std::string hex() const;
+};
+
+struct LevelHashHasher {
+    size_t operator()(const LevelHash &h) const { return h.lo ^ h.hi; }
+};
+
+// The level normalized (see Board::normalize) and in the smallest of its 8
+// symmetric orientations, as u16 width, u16 height, then one byte per cell
+std::vector<uint8_t> canonicalForm(const Board &board);
+
+LevelHash levelHash(const Board &board);
+
+// Hash of arbitrary bytes (MurmurHash3 x64 128)
+LevelHash hashBytes(const uint8_t *data, size_t size, uint64_t seed = 0);
+
+// Streams level files through a thread pool and remembers every hash it
+// has seen, so a pack can be fed in batches of any size
+class LevelDeduper {
+public:
+    explicit LevelDeduper(size_t threads);
+
+    // Loads and hashes files in parallel; returns the indices into files
+    // of levels not seen before, in order. Unreadable files are skipped.
+    // If hashes is given it receives the hash of every file.
+    std::vector<size_t> addFiles(const std::vector<std::string> &files,
+                                 std::vector<LevelHash> *hashes = nullptr);
+
+    size_t uniqueCount() const;
+    size_t duplicateCount() const;
+    size_t failedCount() const;
+
+private:
+    size_t threads_;
+    std::unordered_set<LevelHash, LevelHashHasher> seen_;
+    size_t duplicates_;
+    size_t failed_;
+};
+
+#endif // LEVEL_HASH_H_9b47c15f853c5a1d
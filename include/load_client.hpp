@@ -0,0 +1,32 @@
+#ifndef LOAD_CLIENT_H_9b47c15f853c5a1d
+#define LOAD_CLIENT_H_9b47c15f853c5a1d
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Load generator for Server: opens many sessions and plays random moves
+// on all of them from one epoll loop, a batch of requests at a time.
+struct LoadConfig {
+    std::string unixPath;              // Used when set, otherwise TCP
+    std::string address = "127.0.0.1"; // TCP server address
+    uint16_t port = 0;
+    size_t sessions = 100;
+    size_t requestsPerSession = 1000;
+    size_t pipeline = 16; // Requests sent per batch on each session
+    uint32_t seed = 1;
+};
+
+struct LoadResult {
+    size_t connected = 0;
+    size_t answered = 0; // Answers received over all sessions
+    size_t invalid = 0;  // Answers that were Protocol::Invalid
+    size_t batches = 0;
+    double seconds = 0;
+    double meanBatchMs = 0; // Round trip of one batch, send to last answer
+    double maxBatchMs = 0;
+};
+
+LoadResult runLoad(const LoadConfig &config);
+
+#endif // LOAD_CLIENT_H_9b47c15f853c5a1d
@@ -0,0 +1,79 @@
+#ifndef REPLAY_H_9b47c15f853c5a1d
+#define REPLAY_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "game.hpp"
+#include "input_log.hpp"
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Virtual clock for Game::run. Time only moves when the loop sleeps, by
+// exactly the time asked for, and every input recorded up to the current
+// time is in the game's queue when a frame starts. Once the log runs out
+// the clock sends QUIT so the loop ends.
+class ReplayClock : public FrameClock {
+public:
+    ReplayClock(Game &game, const InputLog &log);
+
+    std::chrono::steady_clock::time_point now() override;
+    void sleepUntil(std::chrono::steady_clock::time_point t) override;
+
+    size_t delivered() const; // Log entries sent so far
+
+private:
+    Game &game_;
+    const InputLog &log_;
+    std::chrono::steady_clock::time_point epoch_;
+    std::chrono::steady_clock::time_point now_;
+    size_t next_;
+    bool quitSent_;
+};
+
+// Percentiles of one kind of per-frame cost, in microseconds
+struct CostSummary {
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+CostSummary summarize(std::vector<std::chrono::nanoseconds> samples);
+
+struct ReplayReport {
+    size_t frames = 0; // Per pass
+    size_t inputs = 0; // Per pass
+    bool completed = false; // The level was solved at the end
+    CostSummary update; // Input handling and update
+    CostSummary render; // Drawing, into a stream that discards the text
+    CostSummary frame;  // Both
+};
+
+// Replays log on a fresh Game on a copy of level, passes times over, with
+// no sleeping. Costs are real time, pooled over all passes.
+ReplayReport replaySession(const Board &level, const InputLog &log,
+                           size_t passes = 1);
+
+// p99 frame costs to compare later replays against
+struct FrameBaseline {
+    double update = 0;
+    double render = 0;
+    double frame = 0;
+
+    static FrameBaseline fromReport(const ReplayReport &report);
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename);
+};
+
+// A p99 regresses when it exceeds baseline * (1 + ratio) + slack
+struct Tolerance {
+    double ratio = 0.10;
+    double slackMicros = 20; // Keeps tiny baselines from flapping
+};
+
+// One message per regressed p99; empty if the report is within tolerance
+std::vector<std::string> checkBaseline(const ReplayReport &report,
+                                       const FrameBaseline &baseline,
+                                       const Tolerance &tolerance);
+
+#endif // REPLAY_H_9b47c15f853c5a1d
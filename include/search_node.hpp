@@ -0,0 +1,125 @@
+#ifndef SEARCH_NODE_H_9b47c15f853c5a1d
+#define SEARCH_NODE_H_9b47c15f853c5a1d
+
+#include "arena.hpp"
+#include "board.hpp"
+#include "game.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// UP/DOWN and LEFT/RIGHT are adjacent in Direction
+inline Direction opposite(Direction dir) {
+    return static_cast<Direction>(static_cast<size_t>(dir) ^ 1);
+}
+
+// A box push: the box on cell `box` moves one cell in `dir`, and the
+// player ends up where the box was
+struct Push {
+    uint32_t box;
+    Direction dir;
+};
+
+// Static layer of a level as seen by a search. Only cells the player can
+// reach from the start (ignoring boxes) get a dense index; everything a
+// search needs about them (neighbours, goals) is a table lookup, and the
+// dynamic layer shrinks to a player cell plus one bit per cell for boxes.
+class Layout {
+public:
+    static constexpr uint32_t None = UINT32_MAX;
+
+    explicit Layout(const Board &board);
+
+    size_t width() const;
+    size_t height() const;
+    size_t cellCount() const;
+    uint32_t cellAt(size_t x, size_t y) const; // None off the floor
+    size_t cellX(uint32_t cell) const;
+    size_t cellY(uint32_t cell) const;
+    uint32_t neighbor(uint32_t cell, Direction dir) const; // None at a wall
+    bool isGoal(uint32_t cell) const;
+    const std::vector<uint32_t> &goals() const;
+    // A box on a dead cell can never reach any goal, whatever else moves
+    bool isDead(uint32_t cell) const;
+
+    // Bytes of a packed box set (one bit per cell)
+    size_t boxBytes() const;
+    static bool hasBox(const uint8_t *boxes, uint32_t cell) {
+        return (boxes[cell >> 3] >> (cell & 7)) & 1;
+    }
+    static void setBox(uint8_t *boxes, uint32_t cell) {
+        boxes[cell >> 3] |= static_cast<uint8_t>(1u << (cell & 7));
+    }
+    static void clearBox(uint8_t *boxes, uint32_t cell) {
+        boxes[cell >> 3] &= static_cast<uint8_t>(~(1u << (cell & 7)));
+    }
+
+    // Reads the player and boxes of board (boxes must hold boxBytes()).
+    // Returns false if one of them is not on an indexed cell.
+    bool encode(const Board &board, uint32_t &player, uint8_t *boxes) const;
+    // Writes player and boxes onto board, which must have this layout's size
+    void decode(uint32_t player, const uint8_t *boxes, Board &board) const;
+
+    // Lowest-index cell the player can walk to without pushing, so states
+    // that only differ by where the player idles compare equal
+    uint32_t normalizePlayer(uint32_t player, const uint8_t *boxes) const;
+
+    // Every push the player can walk up to and make, skipping pushes onto
+    // another box, a wall or a dead cell. Replaces the contents of out.
+    void pushes(uint32_t player, const uint8_t *boxes,
+                std::vector<Push> &out) const;
+    // Moves the box; returns the player's new cell
+    uint32_t applyPush(uint8_t *boxes, const Push &push) const;
+    bool isSolved(const uint8_t *boxes) const; // Every box on a goal
+
+private:
+    size_t width_;
+    size_t height_;
+    std::vector<uint32_t> cellOf_;    // y * width + x -> cell, or None
+    std::vector<uint32_t> position_;  // cell -> y * width + x
+    std::vector<uint32_t> neighbors_; // cell * 4 + Direction -> cell
+    std::vector<uint8_t> isGoal_;
+    std::vector<uint8_t> isDead_;
+    std::vector<uint32_t> goals_;
+    std::vector<uint8_t> goalBits_; // Goals as a packed box set
+};
+
+// Append-only store of search nodes in bump-pointer arenas. A node is
+//   [parent u32][player u24][move u8][box bits ...]
+// padded to 4 bytes, so a level with up to 192 floor cells costs 32 bytes
+// per node. Nodes are addressed by 32-bit index and freed all at once.
+class NodeStore {
+public:
+    static constexpr uint32_t NoParent = UINT32_MAX;
+
+    explicit NodeStore(const Layout &layout, size_t chunkNodes = 1 << 16);
+
+    NodeStore(const NodeStore &) = delete;
+    NodeStore &operator=(const NodeStore &) = delete;
+
+    // move is free for the caller, e.g. the direction of the last push
+    uint32_t add(uint32_t parent, uint32_t player, uint8_t move,
+                 const uint8_t *boxes);
+
+    uint32_t parent(uint32_t node) const;
+    uint32_t player(uint32_t node) const;
+    uint8_t move(uint32_t node) const;
+    const uint8_t *boxes(uint32_t node) const;
+
+    size_t size() const;
+    size_t nodeBytes() const;     // Bytes per node including padding
+    size_t bytesReserved() const; // Memory held by the arena
+    void clear();
+
+private:
+    uint8_t *at(uint32_t node) const;
+
+    size_t boxBytes_;
+    size_t stride_;
+    size_t chunkNodes_;
+    Arena arena_;
+    std::vector<uint8_t *> chunks_;
+    size_t size_;
+};
+
+#endif // SEARCH_NODE_H_9b47c15f853c5a1d
@@ -0,0 +1,92 @@
+#ifndef SERVER_H_9b47c15f853c5a1d
+#define SERVER_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "game.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Wire protocol. Every request is one byte; the server answers each request
+// in order, and all answers produced by one read are sent in one write.
+namespace Protocol {
+// Requests 0x00-0x03 are moves in Direction order (UP, DOWN, LEFT, RIGHT)
+const uint8_t Reset = 0x04; // Restart the level
+const uint8_t State = 0x05; // Fetch the board
+
+// Answer to a move or Reset
+const uint8_t Moved = 0x01;    // The player moved
+const uint8_t Pushed = 0x02;   // ... and pushed a box
+const uint8_t Complete = 0x04; // All boxes are on goals
+const uint8_t Invalid = 0xFF;  // Unknown request
+// Answer to State: u16 width, u16 height (little endian), then width*height
+// Flag bytes row by row
+} // namespace Protocol
+
+// Hosts one Game per connection, all driven by a single epoll loop on the
+// calling thread. Sockets are non-blocking and every session's work is a
+// few array updates, so no client can stall the others. Run several
+// Servers on the same TCP port (SO_REUSEPORT) to use more cores.
+class Server {
+public:
+    explicit Server(const Board &level);
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    // Either or both may be called before run(). Port 0 picks a free port.
+    bool listenTcp(uint16_t port, const std::string &address = "127.0.0.1");
+    bool listenUnix(const std::string &path);
+    uint16_t port() const; // Bound TCP port, 0 if not listening on TCP
+
+    void run();  // Serves until stop() is called
+    void stop(); // Safe to call from any thread
+
+    size_t sessionCount() const;
+
+    // Replaces accept4 on the listening sockets, so tests can inject
+    // failures such as EMFILE. The hook returns a non-blocking descriptor
+    // or -1 with errno set. Call before run().
+    using AcceptHook = std::function<int(int listenFd)>;
+    void setAcceptHook(AcceptHook accept);
+
+private:
+    struct Session {
+        explicit Session(const Board &level);
+        Board board;
+        Game game;
+        std::vector<uint8_t> out; // Answers not yet written
+        size_t outPos = 0;
+        bool wantWrite = false;
+    };
+
+    void acceptAll(int listenFd);
+    void onReadable(int fd);
+    void onWritable(int fd);
+    void handleRequest(Session &session, uint8_t request);
+    bool flush(int fd, Session &session);
+    void updateInterest(int fd, Session &session);
+    void closeSession(int fd);
+    // Adds or removes the listening sockets from epoll; accepts pause while
+    // the process is out of descriptors
+    void watchListeners(bool watch);
+
+    Board level_;
+    int epollFd_;
+    int wakeFd_; // eventfd used by stop()
+    int tcpFd_;
+    int unixFd_;
+    uint16_t port_;
+    bool accepting_; // Listeners are registered with epoll
+    std::string unixPath_;
+    AcceptHook accept_;
+    std::vector<std::unique_ptr<Session>> sessions_; // Indexed by fd
+    std::atomic<size_t> sessionCount_;
+};
+
+#endif // SERVER_H_9b47c15f853c5a1d
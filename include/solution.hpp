@@ -0,0 +1,36 @@
+#ifndef SOLUTION_H_9b47c15f853c5a1d
+#define SOLUTION_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "search_node.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Solutions are LURD strings: u/d/l/r for steps, U/D/L/R for pushes
+
+struct SolutionCheck {
+    bool solved = false; // Every move was legal and the level ends solved
+    size_t moves = 0;
+    size_t pushes = 0;
+};
+
+// Replays lurd on a copy of level with Game's move rules
+SolutionCheck verifySolution(const Board &level, const std::string &lurd);
+
+// Shortest walk from one cell to another around the boxes, as lowercase
+// LURD; returns false if `to` cannot be reached
+bool walkPath(const Layout &layout, uint32_t from, uint32_t to,
+              const uint8_t *boxes, std::string &path);
+
+// Expands a push sequence into a full LURD solution, starting with the
+// player on `player` (not normalized) and the given boxes. Returns false if
+// some push cannot be reached.
+bool pushesToLurd(const Layout &layout, uint32_t player,
+                  std::vector<uint8_t> boxes, const std::vector<Push> &pushes,
+                  std::string &lurd);
+
+char lurdChar(Direction dir, bool push);
+
+#endif // SOLUTION_H_9b47c15f853c5a1d
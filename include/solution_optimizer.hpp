@@ -0,0 +1,42 @@
+#ifndef SOLUTION_OPTIMIZER_H_9b47c15f853c5a1d
+#define SOLUTION_OPTIMIZER_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "search_node.hpp"
+#include "solution.hpp"
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct OptimizerConfig {
+    std::chrono::milliseconds time{1000}; // Wall time for the whole run
+    size_t threads = 1;
+    size_t window = 8; // Pushes per sub-search
+};
+
+struct OptimizeResult {
+    bool valid = false;   // The input solved the level
+    std::string solution; // Never worse than the input; the input if !valid
+    SolutionCheck before;
+    SolutionCheck after;
+    size_t rounds = 0;   // Passes over the solution
+    size_t improved = 0; // Windows that got shorter
+};
+
+// Shortens a solution without adding moves or pushes. The walks between
+// pushes are first replaced by shortest ones; then the push sequence is
+// cut into windows whose end states stay fixed, and each window is
+// searched in parallel for a cheaper way (fewer moves, or as many moves
+// and fewer pushes) between its ends, which may push boxes in another
+// order. Window boundaries shift every round so improvements can cross
+// them; rounds repeat until nothing improves or the time is up.
+OptimizeResult optimizeSolution(const Board &level, const std::string &lurd,
+                                const OptimizerConfig &config);
+
+// The pushes of a LURD solution; false if a move is blocked
+bool lurdToPushes(const Layout &layout, uint32_t player,
+                  std::vector<uint8_t> boxes, const std::string &lurd,
+                  std::vector<Push> &pushes);
+
+#endif // SOLUTION_OPTIMIZER_H_9b47c15f853c5a1d
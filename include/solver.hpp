@@ -0,0 +1,60 @@
+#ifndef SOLVER_H_9b47c15f853c5a1d
+#define SOLVER_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include "search_node.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class SolveStatus { SOLVED, UNSOLVABLE, TIME_OUT, OUT_OF_MEMORY, INVALID };
+
+const char *toString(SolveStatus status);
+
+struct SolverLimits {
+    std::chrono::milliseconds time{1000}; // CPU time of the solving thread
+    size_t memoryBytes = size_t(256) << 20;
+};
+
+struct SolverOptions {
+    // Tunnel and goal-room macros (see LevelAnalysis): far fewer nodes,
+    // but solutions may have more pushes than needed
+    bool macros = false;
+};
+
+struct SolverResult {
+    SolveStatus status = SolveStatus::INVALID;
+    std::string solution; // LURD
+    size_t moves = 0;
+    size_t pushes = 0;
+    size_t nodes = 0; // States stored
+    double seconds = 0; // CPU time
+};
+
+// Lower bound on the pushes left: every box's push distance to its nearest
+// goal, ignoring the other boxes. Tables are built once per level.
+class PushDistances {
+public:
+    explicit PushDistances(const Layout &layout);
+
+    static constexpr uint16_t Unreachable = UINT16_MAX;
+    uint16_t toNearestGoal(uint32_t cell) const;
+    // Unreachable if some box can never reach a goal
+    uint32_t lowerBound(const uint8_t *boxes) const;
+
+private:
+    std::vector<uint16_t> nearest_;
+};
+
+// In-memory A* over pushes with states in a NodeStore. Without macros,
+// solutions are push-optimal; the search stops at the time or memory
+// limit.
+SolverResult solve(const Board &level, const SolverLimits &limits,
+                   const SolverOptions &options = SolverOptions());
+
+// Rough cost of solving a level, for scheduling easy levels first
+double estimateDifficulty(const Board &level);
+
+#endif // SOLVER_H_9b47c15f853c5a1d
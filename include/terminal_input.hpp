@@ -0,0 +1,34 @@
+#ifndef TERMINAL_INPUT_H_9b47c15f853c5a1d
+#define TERMINAL_INPUT_H_9b47c15f853c5a1d
+
+#include "input_queue.hpp"
+#include <atomic>
+#include <termios.h>
+#include <thread>
+
+// Reads keys from a terminal on its own thread and feeds them, timestamped,
+// into an InputQueue. This thread is the queue's only producer.
+class TerminalInput {
+public:
+    explicit TerminalInput(InputQueue &queue, int fd = 0);
+    ~TerminalInput();
+
+    TerminalInput(const TerminalInput &) = delete;
+    TerminalInput &operator=(const TerminalInput &) = delete;
+
+    bool start(); // Switches fd to raw mode and starts the reader thread
+    void stop();  // Joins the thread and restores the terminal
+
+private:
+    void readLoop();
+    void emit(Command command);
+
+    InputQueue &queue_;
+    int fd_;
+    bool rawMode_;
+    struct termios saved_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+#endif // TERMINAL_INPUT_H_9b47c15f853c5a1d
@@ -0,0 +1,91 @@
+#include <board.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <level_analysis.hpp>
+#include <solver.hpp>
+#include <string>
+#include <vector>
+
+// Macro benchmark:
+//   sokoban_analyze [--time MS] [--mem MB] < level_files.txt
+//   e.g. sokoban_analyze < levels/bench/levels.txt from the repository root
+// For every level prints its tunnel cells, articulation cells and goal
+// rooms, then solves it with and without macros and prints the nodes
+// each search stored. The last line sums the levels both searches solved.
+
+int main(int argc, char *argv[]) {
+    SolverLimits limits;
+    limits.time = std::chrono::milliseconds(10000);
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--time" && i + 1 < argc)
+            limits.time = std::chrono::milliseconds(
+                std::strtoull(argv[++i], nullptr, 10));
+        else if (arg == "--mem" && i + 1 < argc)
+            limits.memoryBytes = std::strtoull(argv[++i], nullptr, 10) << 20;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Every column but the first is right-aligned to its header's width
+    const char *const Row = "%-32s %5s %6s %5s %5s %10s %10s %10s %9s\n";
+    std::printf(Row, "level", "cells", "tunnel", "artic", "rooms", "plain",
+                "macros", "saved", "pushes");
+    size_t plainTotal = 0;
+    size_t macroTotal = 0;
+    std::string file;
+    while (std::getline(std::cin, file)) {
+        if (file.empty())
+            continue;
+        Board level;
+        if (!level.loadFromFile(file) || !level.normalize().valid()) {
+            std::cerr << "Skipping " << file << std::endl;
+            continue;
+        }
+        const Layout layout(level);
+        std::vector<uint8_t> boxes(layout.boxBytes());
+        uint32_t player;
+        layout.encode(level, player, boxes.data());
+        const LevelAnalysis analysis(layout, boxes.data());
+
+        SolverOptions macros;
+        macros.macros = true;
+        const SolverResult plain = solve(level, limits);
+        const SolverResult fast = solve(level, limits, macros);
+        const bool both = plain.status == SolveStatus::SOLVED &&
+                          fast.status == SolveStatus::SOLVED;
+        // Either the saving or why a search failed
+        const SolverResult &failed =
+            plain.status != SolveStatus::SOLVED ? plain : fast;
+        char saved[16];
+        std::snprintf(saved, sizeof(saved), "%s", toString(failed.status));
+        if (both) {
+            plainTotal += plain.nodes;
+            macroTotal += fast.nodes;
+            std::snprintf(saved, sizeof(saved), "%.1f%%",
+                          100.0 * (1.0 - double(fast.nodes) / plain.nodes));
+        }
+        std::printf(Row, file.c_str(),
+                    std::to_string(layout.cellCount()).c_str(),
+                    std::to_string(analysis.tunnelCount()).c_str(),
+                    std::to_string(analysis.articulationCount()).c_str(),
+                    std::to_string(analysis.goalRooms().size()).c_str(),
+                    std::to_string(plain.nodes).c_str(),
+                    std::to_string(fast.nodes).c_str(), saved,
+                    (std::to_string(plain.pushes) + "/" +
+                     std::to_string(fast.pushes))
+                        .c_str());
+    }
+    if (plainTotal > 0) {
+        char saved[16];
+        std::snprintf(saved, sizeof(saved), "%.1f%%",
+                      100.0 * (1.0 - double(macroTotal) / plainTotal));
+        std::printf(Row, "total", "", "", "", "",
+                    std::to_string(plainTotal).c_str(),
+                    std::to_string(macroTotal).c_str(), saved, "");
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+Arena::Arena(size_t blockSize)
+    : blockSize_(std::max<size_t>(blockSize, 64)), used_(0), usedDone_(0) {}
+
+void *Arena::allocate(size_t bytes, size_t align) {
+    if (!blocks_.empty()) {
+        Block &block = blocks_.back();
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t offset = ((base + used_ + align - 1) & ~(align - 1)) - base;
+        if (offset + bytes <= block.size) {
+            used_ = offset + bytes;
+            return block.data.get() + offset;
+        }
+        usedDone_ += used_;
+    }
+
+    // Oversized requests get a block of their own
+    const size_t size = std::max(blockSize_, bytes + align);
+    blocks_.push_back(
+        {std::make_unique_for_overwrite<std::byte[]>(size), size});
+    const uintptr_t base =
+        reinterpret_cast<uintptr_t>(blocks_.back().data.get());
+    const size_t offset = ((base + align - 1) & ~(align - 1)) - base;
+    used_ = offset + bytes;
+    return blocks_.back().data.get() + offset;
+}
+
+void Arena::reset() {
+    if (blocks_.size() > 1)
+        blocks_.resize(1);
+    used_ = 0;
+    usedDone_ = 0;
+}
+
+size_t Arena::bytesUsed() const { return usedDone_ + used_; }
+
+size_t Arena::bytesReserved() const {
+    size_t total = 0;
+    for (const Block &block : blocks_) {
+        total += block.size;
+    }
+    return total;
+}
@@ -0,0 +1,83 @@
+#include <batch_solver.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Batch pack solver:
+//   sokoban_batch [--threads N] [--cpu-time MS] [--mem MB] [--attempts N]
+//                 [--growth F] [--format csv|json] [--out file]
+//                 [--macros] < level_files.txt
+// Reads level file paths, one per line, solves them easiest first and
+// streams one report line per level as soon as it is done. Levels that
+// run out of budget are retried with the budget multiplied by --growth.
+// --cpu-time is the CPU time of the thread solving a level, not wall
+// time, so a busy machine slows a batch down without failing its levels.
+// --macros trades push-optimal solutions for a much smaller search.
+
+int main(int argc, char *argv[]) {
+    BatchConfig config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    ReportFormat format = ReportFormat::CSV;
+    std::string outFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            config.threads = std::max(1l, std::atol(argv[++i]));
+        else if (arg == "--cpu-time" && i + 1 < argc)
+            config.limits.time = std::chrono::milliseconds(
+                std::strtoull(argv[++i], nullptr, 10));
+        else if (arg == "--mem" && i + 1 < argc)
+            config.limits.memoryBytes = std::strtoull(argv[++i], nullptr, 10)
+                                        << 20;
+        else if (arg == "--attempts" && i + 1 < argc)
+            config.attempts = std::max(1l, std::atol(argv[++i]));
+        else if (arg == "--growth" && i + 1 < argc)
+            config.growth = std::max(1.0, std::atof(argv[++i]));
+        else if (arg == "--format" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name != "csv" && name != "json") {
+                std::cerr << "Unknown format " << name << std::endl;
+                return 1;
+            }
+            format = name == "csv" ? ReportFormat::CSV : ReportFormat::JSON;
+        } else if (arg == "--out" && i + 1 < argc)
+            outFile = argv[++i];
+        else if (arg == "--macros")
+            config.options.macros = true;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> files;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty())
+            files.push_back(line);
+    }
+
+    std::ofstream file;
+    if (!outFile.empty()) {
+        file.open(outFile, std::ios::trunc);
+        if (!file) {
+            std::cerr << "Cannot write " << outFile << std::endl;
+            return 1;
+        }
+    }
+    ReportWriter writer(outFile.empty() ? std::cout : file, format);
+
+    BatchSolver solver(config);
+    size_t solved = 0;
+    const std::vector<BatchResult> results =
+        solver.run(files, [&](const BatchResult &r) {
+            writer.write(r);
+            solved += r.result.status == SolveStatus::SOLVED;
+        });
+    std::cerr << solved << " of " << results.size() << " levels solved"
+              << std::endl;
+    return solved == results.size() ? 0 : 2;
+}
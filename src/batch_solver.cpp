@@ -0,0 +1,198 @@
+#include "batch_solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace {
+struct Task {
+    size_t attempt;
+    double difficulty;
+    size_t index;
+
+    // priority_queue pops the largest, so "larger" means later
+    bool operator<(const Task &other) const {
+        if (attempt != other.attempt)
+            return attempt > other.attempt;
+        if (difficulty != other.difficulty)
+            return difficulty > other.difficulty;
+        return index > other.index;
+    }
+};
+
+SolverLimits scaled(const SolverLimits &limits, double factor) {
+    SolverLimits out;
+    out.time = std::chrono::milliseconds(
+        static_cast<long long>(limits.time.count() * factor));
+    out.memoryBytes = static_cast<size_t>(limits.memoryBytes * factor);
+    return out;
+}
+
+bool retryable(SolveStatus status) {
+    return status == SolveStatus::TIME_OUT ||
+           status == SolveStatus::OUT_OF_MEMORY;
+}
+
+std::string csvField(const std::string &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos)
+        return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    return out + '"';
+}
+
+std::string jsonString(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out + '"';
+}
+} // namespace
+
+BatchSolver::BatchSolver(BatchConfig config) : config_(config) {
+    config_.threads = std::max<size_t>(config_.threads, 1);
+    config_.attempts = std::max<size_t>(config_.attempts, 1);
+}
+
+std::vector<BatchResult>
+BatchSolver::run(const std::vector<std::string> &files,
+                 const Callback &report) {
+    std::vector<BatchResult> results(files.size());
+    std::vector<Board> levels(files.size());
+    std::vector<uint8_t> loaded(files.size(), 0);
+    const size_t threads = std::min(config_.threads, files.size());
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::priority_queue<Task> queue;
+    size_t remaining = files.size();
+    auto publish = [&](size_t i) {
+        // Called with mutex held
+        if (report)
+            report(results[i]);
+        if (--remaining == 0)
+            wake.notify_all();
+    };
+
+    // Load and score the pack in parallel...
+    std::atomic<size_t> next(0);
+    auto prepare = [&] {
+        for (size_t i = next++; i < files.size(); i = next++) {
+            results[i].index = i;
+            results[i].file = files[i];
+            if (levels[i].loadFromFile(files[i])) {
+                loaded[i] = 1;
+                results[i].difficulty = estimateDifficulty(levels[i]);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(prepare);
+    }
+    prepare();
+    for (std::thread &t : pool) {
+        t.join();
+    }
+    pool.clear();
+
+    // ...then solve it easiest first
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (loaded[i])
+            queue.push({0, results[i].difficulty, i});
+        else
+            publish(i);
+    }
+
+    auto worker = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return !queue.empty() || remaining == 0; });
+            if (queue.empty())
+                return;
+            const Task task = queue.top();
+            queue.pop();
+            lock.unlock();
+
+            const double factor = std::pow(config_.growth, task.attempt);
+            SolverResult solved =
+                solve(levels[task.index], scaled(config_.limits, factor),
+                      config_.options);
+
+            lock.lock();
+            BatchResult &r = results[task.index];
+            r.attempts = task.attempt + 1;
+            r.result = std::move(solved);
+            if (retryable(r.result.status) &&
+                r.attempts < config_.attempts) {
+                queue.push({r.attempts, r.difficulty, task.index});
+                wake.notify_one();
+            } else {
+                publish(task.index);
+            }
+        }
+    };
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    if (threads > 0)
+        worker();
+    for (std::thread &t : pool) {
+        t.join();
+    }
+    return results;
+}
+
+ReportWriter::ReportWriter(std::ostream &out, ReportFormat format)
+    : out_(out), format_(format), header_(false) {}
+
+void ReportWriter::write(const BatchResult &r) {
+    const SolverResult &s = r.result;
+    char seconds[32];
+    std::snprintf(seconds, sizeof(seconds), "%.3f", s.seconds);
+    // Unreadable or invalid levels have no score: an empty CSV field and
+    // a JSON null, never "inf"
+    const bool scored = std::isfinite(r.difficulty);
+    char difficulty[32] = "";
+    if (scored)
+        std::snprintf(difficulty, sizeof(difficulty), "%.2f", r.difficulty);
+
+    if (format_ == ReportFormat::CSV) {
+        if (!header_) {
+            out_ << "index,file,status,moves,pushes,nodes,seconds,attempts,"
+                    "difficulty,solution\n";
+            header_ = true;
+        }
+        out_ << r.index << ',' << csvField(r.file) << ','
+             << toString(s.status) << ',' << s.moves << ',' << s.pushes << ','
+             << s.nodes << ',' << seconds << ',' << r.attempts << ','
+             << difficulty << ',' << s.solution << '\n';
+    } else {
+        out_ << "{\"index\":" << r.index << ",\"file\":" << jsonString(r.file)
+             << ",\"status\":\"" << toString(s.status)
+             << "\",\"moves\":" << s.moves << ",\"pushes\":" << s.pushes
+             << ",\"nodes\":" << s.nodes << ",\"seconds\":" << seconds
+             << ",\"attempts\":" << r.attempts << ",\"difficulty\":"
+             << (scored ? difficulty : "null")
+             << ",\"solution\":\"" << s.solution << "\"}\n";
+    }
+    out_.flush();
+}
@@ -1,4 +1,5 @@
 #include "board.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -48,7 +49,14 @@ bool Board::loadFromFile(const std::string &filename) {
     uint32_t w = 0, h = 0;
     ifs.read(reinterpret_cast<char *>(&w), sizeof(w));
     ifs.read(reinterpret_cast<char *>(&h), sizeof(h));
-    if (!ifs)
+    if (!ifs || w > MaxSide || h > MaxSide)
+        return false;
+    // A damaged header must not size the board beyond what the file holds
+    const std::streampos cells = ifs.tellg();
+    ifs.seekg(0, std::ios::end);
+    const uint64_t bytes = static_cast<uint64_t>(ifs.tellg() - cells);
+    ifs.seekg(cells);
+    if (!ifs || bytes < uint64_t(w) * h * sizeof(uint32_t))
         return false;
     resize(w, h);
     for (size_t j = 0; j < h; ++j) {
@@ -63,11 +71,133 @@ bool Board::loadFromFile(const std::string &filename) {
 
 #include <iostream>
 
-void Board::print() const {
+void Board::print() const { print(std::cout); }
+
+void Board::print(std::ostream &out) const {
     for (size_t j = 0; j < height(); ++j) {
         for (size_t i = 0; i < width(); ++i) {
-            std::cout << Type::toChar(data_[j][i]);
+            out << Type::toChar(data_[j][i]);
+        }
+        out << std::endl;
+    }
+}
+
+namespace {
+// Number of cells in [p, p + n) with any bit of mask set. Plain byte
+// compares over a contiguous row, which compilers turn into SIMD.
+size_t countFlag(const Flag *p, size_t n, Flag mask) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += (p[i] & mask) != 0;
+    }
+    return count;
+}
+} // namespace
+
+LevelCheck Board::normalize() {
+    LevelCheck check;
+    const size_t w = width();
+    const size_t h = height();
+
+    size_t playerPos = 0;
+    for (size_t y = 0; y < h; ++y) {
+        const Flag *row = data_[y].data();
+        const size_t players = countFlag(row, w, At);
+        if (players > 0 && check.players == 0) {
+            const Flag *at = std::find_if(
+                row, row + w, [](Flag f) { return (f & At) != 0; });
+            playerPos = y * w + (at - row);
         }
-        std::cout << std::endl;
+        check.players += players;
+        check.boxes += countFlag(row, w, Box);
+        check.goals += countFlag(row, w, Goal);
     }
-}
\ No newline at end of file
+
+    if (check.players != 1) {
+        check.problems.push_back("level needs exactly one player, found " +
+                                 std::to_string(check.players));
+        return check;
+    }
+
+    // Flood fill the player's area; stepping off the board or onto an
+    // Empty cell means the level is open
+    std::vector<uint8_t> inside(w * h, 0);
+    std::vector<size_t> stack(1, playerPos);
+    inside[playerPos] = 1;
+    check.enclosed = true;
+    size_t boxesInside = 0;
+    size_t goalsInside = 0;
+    while (!stack.empty()) {
+        const size_t pos = stack.back();
+        stack.pop_back();
+        const size_t x = pos % w;
+        const size_t y = pos / w;
+        boxesInside += (data_[y][x] & Box) != 0;
+        goalsInside += (data_[y][x] & Goal) != 0;
+
+        const size_t next[4][2] = {
+            {x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+        for (const auto &[nx, ny] : next) {
+            // Unsigned wrap-around turns the left/top edges into >= w/h
+            if (nx >= w || ny >= h || data_[ny][nx] == Empty) {
+                check.enclosed = false;
+                continue;
+            }
+            const size_t npos = ny * w + nx;
+            if (!inside[npos] && !(data_[ny][nx] & Wall)) {
+                inside[npos] = 1;
+                stack.push_back(npos);
+            }
+        }
+    }
+
+    if (!check.enclosed)
+        check.problems.push_back("level is not enclosed by walls");
+    if (check.boxes == 0)
+        check.problems.push_back("level has no boxes");
+    if (check.boxes != check.goals) {
+        check.problems.push_back(
+            "level has " + std::to_string(check.boxes) + " boxes but " +
+            std::to_string(check.goals) + " goals");
+    }
+    if (boxesInside != check.boxes || goalsInside != check.goals) {
+        check.problems.push_back(
+            "boxes or goals lie outside the player's area");
+    }
+    if (!check.valid())
+        return check;
+
+    // Keep the area and the walls touching it (diagonals included, so
+    // corners survive); everything else becomes Empty
+    std::vector<uint8_t> keep(inside);
+    size_t minX = w, minY = h, maxX = 0, maxY = 0;
+    for (size_t y = 0; y < h; ++y) {
+        for (size_t x = 0; x < w; ++x) {
+            if (!inside[y * w + x])
+                continue;
+            for (size_t ny = y - 1; ny != y + 2; ++ny) {
+                for (size_t nx = x - 1; nx != x + 2; ++nx) {
+                    if (ny < h && nx < w)
+                        keep[ny * w + nx] = 1;
+                }
+            }
+            minX = std::min(minX, x == 0 ? x : x - 1);
+            minY = std::min(minY, y == 0 ? y : y - 1);
+            maxX = std::max(maxX, std::min(x + 1, w - 1));
+            maxY = std::max(maxY, std::min(y + 1, h - 1));
+        }
+    }
+
+    std::vector<std::vector<Flag>> cropped(maxY - minY + 1);
+    for (size_t y = minY; y <= maxY; ++y) {
+        Flag *row = data_[y].data();
+        const uint8_t *mask = keep.data() + y * w;
+        // Branch-free select, vectorizable like countFlag
+        for (size_t x = 0; x < w; ++x) {
+            row[x] = mask[x] ? row[x] : Empty;
+        }
+        cropped[y - minY].assign(row + minX, row + maxX + 1);
+    }
+    data_ = std::move(cropped);
+    return check;
+}
@@ -0,0 +1,219 @@
+#include "board_widget.hpp"
+#include <QKeyEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <algorithm>
+
+using namespace Type;
+
+namespace {
+const int MinTileSize = 4;
+const int MaxTileSize = 64;
+const int FrameIntervalMs = 16;
+} // namespace
+
+BoardWidget::BoardWidget(Game &game, QWidget *parent)
+    : QWidget(parent), game_(game), board_(game.board()), tileSize_(0),
+      originX_(0), originY_(0) {
+    // Reuse toChar's priority rules so the view matches the terminal output
+    for (size_t f = 0; f < tileOf_.size(); ++f) {
+        switch (Type::toChar(static_cast<Flag>(f))) {
+        case 'X':
+            tileOf_[f] = TileWall;
+            break;
+        case '*':
+            tileOf_[f] = TileBoxOnGoal;
+            break;
+        case '+':
+            tileOf_[f] = TilePlayerOnGoal;
+            break;
+        case 'O':
+            tileOf_[f] = TileBox;
+            break;
+        case '@':
+            tileOf_[f] = TilePlayer;
+            break;
+        case 'g':
+            tileOf_[f] = TileGoal;
+            break;
+        case '.':
+        case 's':
+            tileOf_[f] = TileFloor;
+            break;
+        default:
+            tileOf_[f] = TileEmpty;
+            break;
+        }
+    }
+
+    // Every paint covers its whole region, so skip Qt's background erase
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setFocusPolicy(Qt::StrongFocus);
+    resize(640, 480);
+
+    connect(&frameTimer_, &QTimer::timeout, this, [this] { tick(); });
+    frameTimer_.start(FrameIntervalMs);
+}
+
+void BoardWidget::tick() {
+    game_.processInput();
+    if (game_.dirtyCells().empty())
+        return;
+
+    // Invalidate just the touched cells; Qt merges them into one paint
+    for (const auto &[x, y] : game_.dirtyCells()) {
+        update(cellRect(x, y));
+    }
+    game_.clearDirtyCells();
+}
+
+void BoardWidget::refresh() {
+    layout();
+    update();
+}
+
+void BoardWidget::layout() {
+    int tile = MaxTileSize;
+    if (board_.width() > 0 && board_.height() > 0) {
+        tile = std::min(width() / static_cast<int>(board_.width()),
+                        height() / static_cast<int>(board_.height()));
+        tile = std::clamp(tile, MinTileSize, MaxTileSize);
+    }
+    if (tile != tileSize_) {
+        tileSize_ = tile;
+        buildAtlas();
+    }
+    const int boardW = tileSize_ * static_cast<int>(board_.width());
+    const int boardH = tileSize_ * static_cast<int>(board_.height());
+    originX_ = std::max(0, (width() - boardW) / 2);
+    originY_ = std::max(0, (height() - boardH) / 2);
+}
+
+void BoardWidget::buildAtlas() {
+    const int t = tileSize_;
+    atlas_ = QImage(t * TileCount, t, QImage::Format_RGB32);
+    atlas_.fill(Qt::black);
+
+    QPainter p(&atlas_);
+    p.setPen(Qt::NoPen);
+    const QColor floor(200, 190, 160);
+    const QColor goal(220, 60, 60);
+    const QColor box(170, 110, 40);
+    const QColor player(40, 90, 220);
+
+    auto origin = [t](Tile tile) { return QPoint(tile * t, 0); };
+    auto inset = [t](Tile tile, int margin) {
+        return QRect(tile * t + margin, margin, t - 2 * margin,
+                     t - 2 * margin);
+    };
+
+    for (Tile tile : {TileFloor, TileGoal, TileBox, TileBoxOnGoal, TilePlayer,
+                      TilePlayerOnGoal}) {
+        p.fillRect(QRect(origin(tile), QSize(t, t)), floor);
+    }
+    p.fillRect(QRect(origin(TileWall), QSize(t, t)), QColor(90, 90, 100));
+    p.fillRect(inset(TileWall, t / 8), QColor(120, 120, 130));
+
+    p.setBrush(goal);
+    for (Tile tile : {TileGoal, TileBoxOnGoal, TilePlayerOnGoal}) {
+        p.drawEllipse(inset(tile, t / 3));
+    }
+    p.setBrush(Qt::NoBrush);
+
+    p.fillRect(inset(TileBox, t / 8), box);
+    p.fillRect(inset(TileBoxOnGoal, t / 8), box.darker(130));
+    p.fillRect(inset(TileBoxOnGoal, t / 3), goal);
+
+    p.setBrush(player);
+    p.drawEllipse(inset(TilePlayer, t / 6));
+    p.drawEllipse(inset(TilePlayerOnGoal, t / 6));
+}
+
+QRect BoardWidget::boardRect() const {
+    return QRect(originX_, originY_,
+                 tileSize_ * static_cast<int>(board_.width()),
+                 tileSize_ * static_cast<int>(board_.height()));
+}
+
+QRect BoardWidget::cellRect(size_t x, size_t y) const {
+    return QRect(originX_ + static_cast<int>(x) * tileSize_,
+                 originY_ + static_cast<int>(y) * tileSize_, tileSize_,
+                 tileSize_);
+}
+
+void BoardWidget::paintCells(QPainter &painter, const QRect &area) const {
+    const QRect hit = area & boardRect();
+    if (hit.isEmpty())
+        return;
+
+    // Only walk the cells overlapping the invalidated area
+    const size_t x0 = (hit.left() - originX_) / tileSize_;
+    const size_t y0 = (hit.top() - originY_) / tileSize_;
+    const size_t x1 = (hit.right() - originX_) / tileSize_;
+    const size_t y1 = (hit.bottom() - originY_) / tileSize_;
+    for (size_t y = y0; y <= y1; ++y) {
+        const std::vector<Flag> &row = board_[y];
+        for (size_t x = x0; x <= x1; ++x) {
+            const int tile = tileOf_[row[x]];
+            painter.drawImage(cellRect(x, y).topLeft(), atlas_,
+                              QRect(tile * tileSize_, 0, tileSize_,
+                                    tileSize_));
+        }
+    }
+}
+
+void BoardWidget::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    const QRect board = boardRect();
+    for (const QRect &area : event->region()) {
+        // Dirty-cell updates lie inside the board and need no clearing
+        if (!board.contains(area))
+            painter.fillRect(area, Qt::black);
+        paintCells(painter, area);
+    }
+}
+
+void BoardWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    layout();
+}
+
+void BoardWidget::keyPressEvent(QKeyEvent *event) {
+    Command command;
+    switch (event->key()) {
+    case Qt::Key_W:
+    case Qt::Key_Up:
+        command = Command::UP;
+        break;
+    case Qt::Key_S:
+    case Qt::Key_Down:
+        command = Command::DOWN;
+        break;
+    case Qt::Key_A:
+    case Qt::Key_Left:
+        command = Command::LEFT;
+        break;
+    case Qt::Key_D:
+    case Qt::Key_Right:
+        command = Command::RIGHT;
+        break;
+    case Qt::Key_P:
+        command = Command::PAUSE;
+        break;
+    case Qt::Key_Q:
+    case Qt::Key_Escape:
+        close();
+        return;
+    default:
+        QWidget::keyPressEvent(event);
+        return;
+    }
+
+    // The GUI thread is the queue's producer in this frontend; if a burst
+    // ever fills it, apply what is queued and try again
+    const InputEvent input{command, std::chrono::steady_clock::now()};
+    while (!game_.inputQueue().push(input)) {
+        tick();
+    }
+}
@@ -0,0 +1,56 @@
+#include <cstdlib>
+#include <iostream>
+#include <level_hash.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Level pack deduplication:
+//   sokoban_dedup [--threads N] [--hash] < level_files.txt
+// Reads level file paths, one per line, and prints the path of every level
+// that is not a rotation, mirror or re-padding of an earlier one. --hash
+// prefixes each line with the level's canonical hash.
+
+namespace {
+const size_t BatchSize = 4096;
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool printHash = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            threads = std::max(1l, std::atol(argv[++i]));
+        else if (arg == "--hash")
+            printHash = true;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+    LevelDeduper deduper(threads);
+    std::vector<std::string> batch;
+    std::vector<LevelHash> hashes;
+    std::string line;
+    while (std::cin) {
+        batch.clear();
+        while (batch.size() < BatchSize && std::getline(std::cin, line)) {
+            if (!line.empty())
+                batch.push_back(line);
+        }
+        for (size_t i : deduper.addFiles(batch, &hashes)) {
+            if (printHash)
+                std::cout << hashes[i].hex() << ' ';
+            std::cout << batch[i] << '\n';
+        }
+    }
+    std::cout.flush();
+
+    std::cerr << deduper.uniqueCount() << " unique, "
+              << deduper.duplicateCount() << " duplicates, "
+              << deduper.failedCount() << " unreadable" << std::endl;
+    return 0;
+}
@@ -0,0 +1,588 @@
+#include "external_search.hpp"
+#include "level_hash.hpp"
+#include "solution.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Merge buffers are carved out of the memory budget within these bounds
+const size_t MinMergeBuffer = 4096;
+const size_t MaxMergeBuffer = 1 << 20;
+// Runs read at once; each costs a descriptor and a merge buffer, so more
+// runs than this are merged in several passes
+const size_t MaxFanIn = 64;
+const char Magic[4] = {'S', 'K', 'L', '1'};
+const char CheckpointName[] = "checkpoint";
+
+uint32_t readPlayer(const uint8_t *p) {
+    return p[0] | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+}
+
+void writePlayer(uint8_t *p, uint32_t player) {
+    p[0] = static_cast<uint8_t>(player);
+    p[1] = static_cast<uint8_t>(player >> 8);
+    p[2] = static_cast<uint8_t>(player >> 16);
+}
+
+// K-way merge of sorted run files, yielding every distinct record once
+class RunMerge {
+public:
+    bool open(const std::vector<std::string> &files, size_t recordBytes,
+              size_t bufferBytes) {
+        recordBytes_ = recordBytes;
+        readers_ = std::vector<RecordReader>(files.size());
+        heap_.clear();
+        haveLast_ = false;
+        bad_ = false;
+        last_.assign(recordBytes, 0);
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!readers_[i].open(files[i], recordBytes, bufferBytes))
+                return false;
+            if (readers_[i].next(nullptr))
+                push(i);
+            bad_ |= readers_[i].bad();
+        }
+        return !bad_;
+    }
+
+    bool next(uint8_t *record) {
+        while (!heap_.empty() && !bad_) {
+            std::pop_heap(heap_.begin(), heap_.end(), greater());
+            const size_t top = heap_.back();
+            heap_.pop_back();
+            std::memcpy(record, readers_[top].current(), recordBytes_);
+            if (readers_[top].next(nullptr))
+                push(top);
+            else if (readers_[top].bad())
+                bad_ = true;
+            if (haveLast_ &&
+                std::memcmp(last_.data(), record, recordBytes_) == 0)
+                continue; // Same record from several runs
+            std::memcpy(last_.data(), record, recordBytes_);
+            haveLast_ = true;
+            return true;
+        }
+        return false;
+    }
+
+    bool bad() const { return bad_; } // A run turned out damaged
+
+private:
+    // Heap order: the reader with the smallest current record on top
+    struct Greater {
+        const RunMerge *merge;
+        bool operator()(size_t a, size_t b) const {
+            return std::memcmp(merge->readers_[a].current(),
+                               merge->readers_[b].current(),
+                               merge->recordBytes_) > 0;
+        }
+    };
+
+    Greater greater() const { return Greater{this}; }
+
+    void push(size_t reader) {
+        heap_.push_back(reader);
+        std::push_heap(heap_.begin(), heap_.end(), greater());
+    }
+
+    std::vector<RecordReader> readers_;
+    std::vector<size_t> heap_; // Readers with records left
+    std::vector<uint8_t> last_;
+    size_t recordBytes_ = 0;
+    bool haveLast_ = false;
+    bool bad_ = false;
+};
+} // namespace
+
+bool RecordWriter::open(const std::string &path, size_t recordBytes,
+                        size_t bufferBytes) {
+    buffer_.resize(bufferBytes);
+    out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    recordBytes_ = recordBytes;
+    previous_.assign(recordBytes, 0);
+    count_ = 0;
+    const uint32_t size = static_cast<uint32_t>(recordBytes);
+    out_.write(Magic, sizeof(Magic));
+    out_.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    return out_.good();
+}
+
+void RecordWriter::write(const uint8_t *record) {
+    size_t shared = 0;
+    if (count_ > 0) {
+        while (shared < recordBytes_ && record[shared] == previous_[shared])
+            ++shared;
+    }
+    // Varint prefix length
+    size_t v = shared;
+    do {
+        char byte = static_cast<char>((v & 0x7F) | (v > 0x7F ? 0x80 : 0));
+        out_.put(byte);
+        v >>= 7;
+    } while (v);
+    out_.write(reinterpret_cast<const char *>(record + shared),
+               recordBytes_ - shared);
+    std::memcpy(previous_.data() + shared, record + shared,
+                recordBytes_ - shared);
+    count_++;
+}
+
+bool RecordWriter::close() {
+    out_.flush();
+    const bool ok = out_.good();
+    out_.close();
+    return ok;
+}
+
+size_t RecordWriter::count() const { return count_; }
+
+bool RecordReader::open(const std::string &path, size_t recordBytes,
+                        size_t bufferBytes) {
+    buffer_.resize(bufferBytes);
+    in_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+    in_.open(path, std::ios::binary);
+    recordBytes_ = recordBytes;
+    current_.assign(recordBytes, 0);
+    bad_ = false;
+
+    char magic[sizeof(Magic)];
+    uint32_t size = 0;
+    in_.read(magic, sizeof(magic));
+    in_.read(reinterpret_cast<char *>(&size), sizeof(size));
+    return in_.good() && std::memcmp(magic, Magic, sizeof(Magic)) == 0 &&
+           size == recordBytes;
+}
+
+bool RecordReader::next(uint8_t *record) {
+    size_t shared = 0;
+    int shift = 0;
+    int byte;
+    do {
+        byte = in_.get();
+        if (byte == std::char_traits<char>::eof()) {
+            // Only a file ending between records ends cleanly
+            bad_ = shift > 0 || in_.bad();
+            return false;
+        }
+        shared |= size_t(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && shift < 64);
+    if ((byte & 0x80) || shared > recordBytes_) {
+        bad_ = true;
+        return false;
+    }
+
+    in_.read(reinterpret_cast<char *>(current_.data() + shared),
+             recordBytes_ - shared);
+    if (!in_) {
+        bad_ = true;
+        return false;
+    }
+    if (record)
+        std::memcpy(record, current_.data(), recordBytes_);
+    return true;
+}
+
+const uint8_t *RecordReader::current() const { return current_.data(); }
+
+bool RecordReader::bad() const { return bad_; }
+
+ExternalSearch::ExternalSearch(const Board &level, ExternalSearchConfig config)
+    : level_(level), layout_(level), config_(std::move(config)),
+      boxBytes_(layout_.boxBytes()), recordBytes_(boxBytes_ + 3) {
+    // The exact level (not its canonical form: a rotated level has other
+    // cell numbers) decides whether a checkpoint belongs to this search
+    std::vector<uint8_t> cells;
+    for (size_t y = 0; y < level_.height(); ++y) {
+        cells.push_back(static_cast<uint8_t>(level_.width()));
+        cells.insert(cells.end(), level_[y].begin(), level_[y].end());
+    }
+    levelId_ = hashBytes(cells.data(), cells.size()).hex();
+}
+
+std::string ExternalSearch::path(const std::string &name) const {
+    return (fs::path(config_.workDir) / name).string();
+}
+
+std::string ExternalSearch::layerPath(size_t depth) const {
+    return path("layer-" + std::to_string(depth) + ".dat");
+}
+
+std::string ExternalSearch::visitedPath(size_t depth) const {
+    return path("visited-" + std::to_string(depth) + ".dat");
+}
+
+bool ExternalSearch::loadCheckpoint(Checkpoint &cp) const {
+    std::ifstream in(path(CheckpointName));
+    std::string tag, level;
+    int version = 0;
+    size_t record = 0;
+    if (!(in >> tag >> version) || tag != "sokoban-external-search" ||
+        version != 1)
+        return false;
+    std::string key;
+    while (in >> key) {
+        if (key == "level")
+            in >> level;
+        else if (key == "record")
+            in >> record;
+        else if (key == "depth")
+            in >> cp.depth;
+        else if (key == "layer")
+            in >> cp.layerCount;
+        else if (key == "visited")
+            in >> cp.visitedCount;
+        else if (key == "runs")
+            in >> cp.runs;
+    }
+    return level == levelId_ && record == recordBytes_ &&
+           fs::exists(layerPath(cp.depth)) &&
+           fs::exists(visitedPath(cp.depth));
+}
+
+bool ExternalSearch::saveCheckpoint(const Checkpoint &cp) const {
+    // Write aside and rename, so a crash leaves the old checkpoint intact
+    const std::string tmp = path(std::string(CheckpointName) + ".tmp");
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << "sokoban-external-search 1\n"
+            << "level " << levelId_ << "\n"
+            << "record " << recordBytes_ << "\n"
+            << "depth " << cp.depth << "\n"
+            << "layer " << cp.layerCount << "\n"
+            << "visited " << cp.visitedCount << "\n"
+            << "runs " << cp.runs << "\n";
+        out.flush();
+        if (!out)
+            return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path(CheckpointName), ec);
+    return !ec;
+}
+
+bool ExternalSearch::start(Checkpoint &cp) {
+    std::vector<uint8_t> boxes(boxBytes_);
+    uint32_t player = 0;
+    if (!layout_.encode(level_, player, boxes.data()))
+        return false;
+
+    std::vector<uint8_t> record(boxes);
+    record.resize(recordBytes_);
+    writePlayer(record.data() + boxBytes_,
+                layout_.normalizePlayer(player, boxes.data()));
+
+    for (const std::string &file : {layerPath(0), visitedPath(0)}) {
+        RecordWriter writer;
+        if (!writer.open(file, recordBytes_))
+            return false;
+        writer.write(record.data());
+        if (!writer.close())
+            return false;
+    }
+    cp = Checkpoint();
+    cp.layerCount = 1;
+    cp.visitedCount = 1;
+    return saveCheckpoint(cp);
+}
+
+void ExternalSearch::successors(const uint8_t *record,
+                                std::vector<uint8_t> &out,
+                                std::vector<Push> *pushList) const {
+    thread_local std::vector<Push> pushes;
+    thread_local std::vector<uint8_t> boxes;
+    layout_.pushes(readPlayer(record + boxBytes_), record, pushes);
+
+    out.resize(pushes.size() * recordBytes_);
+    for (size_t i = 0; i < pushes.size(); ++i) {
+        boxes.assign(record, record + boxBytes_);
+        const uint32_t player = layout_.applyPush(boxes.data(), pushes[i]);
+        uint8_t *next = out.data() + i * recordBytes_;
+        std::memcpy(next, boxes.data(), boxBytes_);
+        writePlayer(next + boxBytes_,
+                    layout_.normalizePlayer(player, boxes.data()));
+    }
+    if (pushList)
+        *pushList = pushes;
+}
+
+std::string ExternalSearch::runPath(size_t index) const {
+    return path("run-" + std::to_string(index) + ".tmp");
+}
+
+bool ExternalSearch::spillRun(std::vector<uint8_t> &buffer, size_t runIndex) {
+    const size_t n = buffer.size() / recordBytes_;
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    const uint8_t *base = buffer.data();
+    const size_t rb = recordBytes_;
+    std::sort(order.begin(), order.end(), [base, rb](size_t a, size_t b) {
+        return std::memcmp(base + a * rb, base + b * rb, rb) < 0;
+    });
+
+    RecordWriter writer;
+    if (!writer.open(runPath(runIndex), rb))
+        return false;
+    const uint8_t *last = nullptr;
+    for (size_t i : order) {
+        const uint8_t *record = base + i * rb;
+        if (last && std::memcmp(last, record, rb) == 0)
+            continue;
+        writer.write(record);
+        last = record;
+    }
+    buffer.clear();
+    return writer.close();
+}
+
+bool ExternalSearch::expand(Checkpoint &cp, bool &solved,
+                            std::vector<uint8_t> &goal) {
+    const size_t rb = recordBytes_;
+    // Each buffered record also costs a sort index. The buffer must hold
+    // at least the successors of one state: four pushes per box.
+    const size_t maxBuffered =
+        std::max(config_.memoryBytes / (rb + sizeof(size_t)),
+                 4 * layout_.goals().size());
+
+    // 1. Stream layer d, spilling sorted runs of successors
+    RecordReader layer;
+    if (!layer.open(layerPath(cp.depth), rb))
+        return false;
+    // Reserved up front: growing by doubling would overshoot the budget
+    std::vector<uint8_t> buffer;
+    buffer.reserve(maxBuffered * rb);
+    std::vector<uint8_t> next;
+    std::vector<uint8_t> record(rb);
+    size_t runs = 0;
+    while (layer.next(record.data())) {
+        successors(record.data(), next);
+        // Spill before the successors would not fit, never after
+        if (buffer.size() + next.size() > buffer.capacity() &&
+            !spillRun(buffer, runs++))
+            return false;
+        buffer.insert(buffer.end(), next.begin(), next.end());
+    }
+    if (layer.bad())
+        return false;
+    if (!buffer.empty() && !spillRun(buffer, runs++))
+        return false;
+    std::vector<uint8_t>().swap(buffer);
+    cp.runs += runs;
+
+    // 2. Merge runs a bounded number at a time until one pass can take
+    // them all alongside the visited file
+    const size_t fanIn = std::clamp(config_.memoryBytes / MinMergeBuffer,
+                                    size_t(2), MaxFanIn);
+    const size_t ioBytes =
+        std::clamp(config_.memoryBytes / (fanIn + 3), MinMergeBuffer,
+                   MaxMergeBuffer);
+    std::vector<size_t> pending(runs);
+    for (size_t i = 0; i < runs; ++i) {
+        pending[i] = i;
+    }
+    size_t nextRun = runs;
+    while (pending.size() > fanIn) {
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < pending.size(); i += fanIn) {
+            const size_t end = std::min(i + fanIn, pending.size());
+            if (end - i == 1) {
+                merged.push_back(pending[i]);
+                continue;
+            }
+            std::vector<std::string> inputs;
+            for (size_t j = i; j < end; ++j) {
+                inputs.push_back(runPath(pending[j]));
+            }
+            RunMerge merge;
+            RecordWriter writer;
+            if (!merge.open(inputs, rb, ioBytes) ||
+                !writer.open(runPath(nextRun), rb, ioBytes))
+                return false;
+            while (merge.next(record.data())) {
+                writer.write(record.data());
+            }
+            if (merge.bad() || !writer.close())
+                return false;
+            for (const std::string &input : inputs) {
+                fs::remove(input);
+            }
+            merged.push_back(nextRun++);
+        }
+        pending = std::move(merged);
+    }
+
+    // 3. Merge the last runs and the visited file in one pass
+    std::vector<std::string> inputs;
+    for (size_t run : pending) {
+        inputs.push_back(runPath(run));
+    }
+    RunMerge merge;
+    if (!merge.open(inputs, rb, ioBytes))
+        return false;
+
+    RecordReader visited;
+    if (!visited.open(visitedPath(cp.depth), rb, ioBytes))
+        return false;
+    bool visitedMore = visited.next(nullptr);
+
+    const std::string layerTmp = layerPath(cp.depth + 1) + ".tmp";
+    const std::string visitedTmp = visitedPath(cp.depth + 1) + ".tmp";
+    RecordWriter newLayer;
+    RecordWriter newVisited;
+    if (!newLayer.open(layerTmp, rb, ioBytes) ||
+        !newVisited.open(visitedTmp, rb, ioBytes))
+        return false;
+
+    while (merge.next(record.data())) {
+        // Copy over visited states that sort before this one
+        int cmp = 1;
+        while (visitedMore &&
+               (cmp = std::memcmp(visited.current(), record.data(), rb)) < 0) {
+            newVisited.write(visited.current());
+            visitedMore = visited.next(nullptr);
+        }
+        if (visitedMore && cmp == 0)
+            continue; // Seen in an earlier layer
+
+        newLayer.write(record.data());
+        newVisited.write(record.data());
+        if (!solved && layout_.isSolved(record.data())) {
+            solved = true;
+            goal = record;
+        }
+    }
+    while (visitedMore) {
+        newVisited.write(visited.current());
+        visitedMore = visited.next(nullptr);
+    }
+    // A damaged run or visited file would silently drop states
+    if (merge.bad() || visited.bad())
+        return false;
+
+    const size_t layerCount = newLayer.count();
+    const size_t visitedCount = newVisited.count();
+    if (!newLayer.close() || !newVisited.close())
+        return false;
+    for (const std::string &input : inputs) {
+        fs::remove(input);
+    }
+
+    // 4. Publish the layer, then the checkpoint; the old visited file is
+    // only dropped once the checkpoint no longer points at it
+    std::error_code ec;
+    fs::rename(layerTmp, layerPath(cp.depth + 1), ec);
+    if (!ec)
+        fs::rename(visitedTmp, visitedPath(cp.depth + 1), ec);
+    if (ec)
+        return false;
+    cp.depth++;
+    cp.layerCount = layerCount;
+    cp.visitedCount = visitedCount;
+    if (!saveCheckpoint(cp))
+        return false;
+    fs::remove(visitedPath(cp.depth - 1));
+    return true;
+}
+
+bool ExternalSearch::reconstruct(size_t depth, std::vector<uint8_t> goal,
+                                 std::string &lurd) {
+    // Walk the layers backwards, finding a parent of each state in turn
+    std::vector<Push> path;
+    std::vector<Push> pushes;
+    std::vector<uint8_t> next;
+    std::vector<uint8_t> record(recordBytes_);
+    for (size_t d = depth; d-- > 0;) {
+        RecordReader layer;
+        if (!layer.open(layerPath(d), recordBytes_))
+            return false;
+        bool found = false;
+        while (!found && layer.next(record.data())) {
+            successors(record.data(), next, &pushes);
+            for (size_t i = 0; i < pushes.size(); ++i) {
+                if (std::memcmp(next.data() + i * recordBytes_, goal.data(),
+                                recordBytes_) == 0) {
+                    path.push_back(pushes[i]);
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found || layer.bad())
+            return false;
+        goal = record;
+    }
+    std::reverse(path.begin(), path.end());
+
+    std::vector<uint8_t> boxes(boxBytes_);
+    uint32_t player = 0;
+    layout_.encode(level_, player, boxes.data());
+    return pushesToLurd(layout_, player, boxes, path, lurd);
+}
+
+ExternalSearchResult ExternalSearch::run() {
+    ExternalSearchResult result;
+    std::error_code ec;
+    fs::create_directories(config_.workDir, ec);
+
+    // Runs and half-written files of an interrupted layer are worthless
+    for (const auto &entry : fs::directory_iterator(config_.workDir, ec)) {
+        if (entry.path().extension() == ".tmp")
+            fs::remove(entry.path(), ec);
+    }
+
+    Checkpoint cp;
+    if (config_.resume && loadCheckpoint(cp)) {
+        result.resumed = true;
+    } else if (!start(cp)) {
+        result.ioError = true;
+        return result;
+    }
+
+    std::vector<uint8_t> goal;
+    bool solved = false;
+    // A resumed search may already have the goal in its last layer
+    {
+        RecordReader layer;
+        std::vector<uint8_t> record(recordBytes_);
+        if (layer.open(layerPath(cp.depth), recordBytes_)) {
+            while (!solved && layer.next(record.data())) {
+                if (layout_.isSolved(record.data())) {
+                    solved = true;
+                    goal = record;
+                }
+            }
+            result.ioError = layer.bad();
+        } else {
+            result.ioError = true;
+        }
+    }
+
+    while (!result.ioError && !solved && cp.layerCount > 0 &&
+           cp.depth < config_.maxDepth) {
+        if (!expand(cp, solved, goal)) {
+            result.ioError = true;
+            break;
+        }
+    }
+
+    result.depth = cp.depth;
+    result.states = cp.visitedCount;
+    result.runs = cp.runs;
+    result.exhausted = !solved && !result.ioError && cp.layerCount == 0;
+    for (const auto &entry : fs::directory_iterator(config_.workDir, ec)) {
+        if (entry.is_regular_file())
+            result.diskBytes += entry.file_size();
+    }
+    if (solved) {
+        // Every layer holds a parent of the goal unless one is damaged
+        result.solved = reconstruct(cp.depth, goal, result.solution);
+        result.ioError = !result.solved;
+    }
+    return result;
+}
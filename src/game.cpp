@@ -1,6 +1,21 @@
 #include "game.hpp"
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <thread>
+#include <utility>
+
+namespace {
+class SteadyFrameClock : public FrameClock {
+public:
+    std::chrono::steady_clock::time_point now() override {
+        return std::chrono::steady_clock::now();
+    }
+    void sleepUntil(std::chrono::steady_clock::time_point t) override {
+        std::this_thread::sleep_until(t);
+    }
+};
+} // namespace
 
 // Singleton implementation
 Game &Game::instance() {
@@ -8,9 +23,17 @@ Game &Game::instance() {
     return inst;
 }
 
-Game::Game()
-    : state_(GameState::MENU), board_(Board::instance()), playerX_(0),
-      playerY_(0), numBoxes_(0), numBoxesOnGoal_(0) {}
+Game::Game() : Game(Board::instance()) {}
+
+Game::Game(Board &board, Input input)
+    : state_(GameState::MENU), board_(board), playerX_(0), playerY_(0),
+      numBoxes_(0), numBoxesOnGoal_(0),
+      inputQueue_(input == Input::Queued ? std::make_unique<InputQueue>()
+                                         : nullptr),
+      inputLog_(nullptr),
+      lastFrameTime_(std::chrono::steady_clock::now()), out_(&std::cout) {}
+
+const Board &Game::board() const { return board_; }
 
 bool Game::initialize() {
     // Initialize game state
@@ -42,71 +65,101 @@ bool Game::initialize() {
     countBoxes();
 
     // Initialize timing
-    lastFrameTime_ = std::chrono::high_resolution_clock::now();
+    lastFrameTime_ = std::chrono::steady_clock::now();
 
     return true;
 }
 
 void Game::run() {
+    SteadyFrameClock clock;
+    run(clock, std::cout);
+}
+
+void Game::run(FrameClock &clock, std::ostream &out,
+               std::vector<FrameCost> *costs) {
     state_ = GameState::PLAYING;
+    out_ = &out;
+    lastFrameTime_ = clock.now();
 
     // Main game loop
     while (state_ != GameState::QUIT) {
         // Calculate delta time
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> diff = currentTime - lastFrameTime_;
+        const auto frameStart = clock.now();
+        std::chrono::duration<double> diff = frameStart - lastFrameTime_;
         double deltaTime = diff.count();
-        lastFrameTime_ = currentTime;
+        lastFrameTime_ = frameStart;
+        const auto t0 = std::chrono::steady_clock::now();
 
         // Process player input
-        processInput();
+        processInput(frameStart);
 
         // Update game state
         if (state_ == GameState::PLAYING) {
             update(deltaTime);
         }
+        const auto t1 = std::chrono::steady_clock::now();
 
-        // Render the game
+        // Render the game; the terminal view redraws everything, so the
+        // dirty cells are done with
         render();
+        clearDirtyCells();
+        const auto t2 = std::chrono::steady_clock::now();
+        if (costs)
+            costs->push_back({t1 - t0, t2 - t1});
 
         // Check for level completion
         if (isLevelComplete() && state_ == GameState::PLAYING) {
             state_ = GameState::LEVEL_COMPLETE;
-            std::cout << "Level Complete!" << std::endl;
+            out << "Level Complete!" << std::endl;
         }
 
-        // Simple frame limiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Frame limiting: sleep out the rest of the frame
+        clock.sleepUntil(frameStart + FrameInterval);
     }
+    out_ = &std::cout;
 }
 
 void Game::pause() {
     if (state_ == GameState::PLAYING) {
         state_ = GameState::PAUSED;
-        std::cout << "Game paused" << std::endl;
+        *out_ << "Game paused" << std::endl;
     }
 }
 
 void Game::resume() {
     if (state_ == GameState::PAUSED) {
         state_ = GameState::PLAYING;
-        std::cout << "Game resumed" << std::endl;
+        *out_ << "Game resumed" << std::endl;
     }
 }
 
 void Game::quit() {
     state_ = GameState::QUIT;
-    std::cout << "Quitting game" << std::endl;
+    *out_ << "Quitting game" << std::endl;
 }
 
 bool Game::loadLevel(const std::string &filename) {
-    if (board_.loadFromFile(filename)) {
-        findPlayer();
-        countBoxes();
-        state_ = GameState::PLAYING;
-        return true;
+    // Load into a scratch board so a rejected level leaves the current one
+    // and its player, box counts and state untouched
+    Board level;
+    if (!level.loadFromFile(filename)) {
+        return false;
     }
-    return false;
+
+    // Reject broken levels and trim their exterior before anything scans it
+    LevelCheck check = level.normalize();
+    if (!check.valid()) {
+        for (const std::string &problem : check.problems) {
+            std::cerr << filename << ": " << problem << std::endl;
+        }
+        return false;
+    }
+
+    board_ = std::move(level);
+    findPlayer();
+    countBoxes();
+    state_ = GameState::PLAYING;
+    return true;
 }
 
 bool Game::isLevelComplete() const {
@@ -194,12 +247,16 @@ bool Game::movePlayer(Direction dir) {
         if ((destTile & Type::Goal) && (destTile & Type::Box)) {
             numBoxesOnGoal_--;
         }
+        dirtyCells_.emplace_back(boxNewX, boxNewY);
     }
 
     // Move player
     board_[newY][newX] = board_[newY][newX] | Type::At;
     board_[playerY_][playerX_] = board_[playerY_][playerX_] & ~Type::At;
 
+    dirtyCells_.emplace_back(newX, newY);
+    dirtyCells_.emplace_back(playerX_, playerY_);
+
     // Update player position
     playerX_ = newX;
     playerY_ = newY;
@@ -211,6 +268,12 @@ bool Game::movePlayer(Direction dir) {
     return true;
 }
 
+const std::vector<std::pair<size_t, size_t>> &Game::dirtyCells() const {
+    return dirtyCells_;
+}
+
+void Game::clearDirtyCells() { dirtyCells_.clear(); }
+
 void Game::update(double deltaTime) {
     // Any time-based updates would go here
     // For now, we'll just use this to update game state
@@ -219,61 +282,100 @@ void Game::update(double deltaTime) {
 
 void Game::render() const {
     // Clear screen
-    std::cout << "\033[2J\033[1;1H";
+    *out_ << "\033[2J\033[1;1H";
 
     // Print game status
-    std::cout << "Sokoban - ";
+    *out_ << "Sokoban - ";
     switch (state_) {
     case GameState::MENU:
-        std::cout << "Main Menu";
+        *out_ << "Main Menu";
         break;
     case GameState::PLAYING:
-        std::cout << "Playing";
+        *out_ << "Playing";
         break;
     case GameState::PAUSED:
-        std::cout << "Paused";
+        *out_ << "Paused";
         break;
     case GameState::LEVEL_COMPLETE:
-        std::cout << "Level Complete!";
+        *out_ << "Level Complete!";
         break;
     case GameState::GAME_OVER:
-        std::cout << "Game Over";
+        *out_ << "Game Over";
         break;
     case GameState::QUIT:
-        std::cout << "Quitting";
+        *out_ << "Quitting";
         break;
     }
-    std::cout << std::endl;
+    *out_ << std::endl;
 
     // Print board state
-    std::cout << "Boxes on goal: " << numBoxesOnGoal_ << "/" << numBoxes_
+    *out_ << "Boxes on goal: " << numBoxesOnGoal_ << "/" << numBoxes_
               << std::endl;
 
     // Print the board
-    board_.print();
+    board_.print(*out_);
 
     // Print controls
-    std::cout << "Controls: WASD = Move, P = Pause, Q = Quit" << std::endl;
+    *out_ << "Controls: WASD = Move, P = Pause, Q = Quit" << std::endl;
+}
+
+InputQueue &Game::inputQueue() { return *inputQueue_; }
+
+void Game::processInput() { processInput(std::chrono::steady_clock::now()); }
+
+void Game::processInput(std::chrono::steady_clock::time_point now) {
+    if (!inputQueue_)
+        return;
+    // Take the whole backlog in one batch so held keys never pile up
+    inputQueue_->drain([this, now](const InputEvent &event) {
+        recordLatency(now - event.timestamp);
+        if (inputLog_)
+            inputLog_->record(event);
+        handleCommand(event.command);
+    });
+}
+
+const InputLatency &Game::inputLatency() const { return inputLatency_; }
+
+void Game::recordInputs(InputLog *log) {
+    inputLog_ = log;
+    if (log)
+        log->start = std::chrono::steady_clock::now();
+}
+
+void Game::handleCommand(Command command) {
+    switch (command) {
+    case Command::UP:
+    case Command::DOWN:
+    case Command::LEFT:
+    case Command::RIGHT:
+        if (state_ != GameState::PAUSED && state_ != GameState::QUIT) {
+            movePlayer(static_cast<Direction>(command));
+        }
+        break;
+    case Command::PAUSE:
+        if (state_ == GameState::PLAYING)
+            pause();
+        else if (state_ == GameState::PAUSED)
+            resume();
+        break;
+    case Command::QUIT:
+        quit();
+        break;
+    }
 }
 
-void Game::processInput() {
-    // In a real implementation, this would handle keyboard input
-    // For now, this is a placeholder that would be replaced with actual input
-    // handling using a library like SDL or GLFW, or Qt input handling
-
-    // Example of how we might process input when integrated with Qt or ncurses:
-    // char key = getInputChar();
-    // switch (key) {
-    //     case 'w': movePlayer(Direction::UP); break;
-    //     case 's': movePlayer(Direction::DOWN); break;
-    //     case 'a': movePlayer(Direction::LEFT); break;
-    //     case 'd': movePlayer(Direction::RIGHT); break;
-    //     case 'p':
-    //         if (state_ == GameState::PLAYING) pause();
-    //         else if (state_ == GameState::PAUSED) resume();
-    //         break;
-    //     case 'q': quit(); break;
-    // }
+void Game::recordLatency(std::chrono::nanoseconds waited) {
+    waited = std::max(waited, std::chrono::nanoseconds(0));
+    inputLatency_.count++;
+    inputLatency_.total += waited;
+    inputLatency_.max = std::max(inputLatency_.max, waited);
+
+    const auto us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(waited).count());
+    const size_t bucket = std::min<size_t>(std::bit_width(us),
+                                           inputLatency_.histogram.size() - 1);
+    inputLatency_.histogram[bucket]++;
 }
 
 bool Game::tryMove(size_t fromX, size_t fromY, size_t toX, size_t toY) {
@@ -0,0 +1,54 @@
+#include "input_log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+const char Header[] = "sokoban-inputs 1";
+// Indexed by Command
+const char Letters[] = "udlrpq";
+} // namespace
+
+void InputLog::record(const InputEvent &event) {
+    const auto at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        event.timestamp - start);
+    entries.push_back({std::max(at, std::chrono::nanoseconds(0)),
+                       event.command});
+}
+
+bool InputLog::save(const std::string &filename) const {
+    std::ofstream out(filename, std::ios::trunc);
+    out << Header << "\n";
+    for (const Entry &e : entries) {
+        out << e.at.count() << ' '
+            << Letters[static_cast<size_t>(e.command)] << "\n";
+    }
+    out.flush();
+    return out.good();
+}
+
+bool InputLog::load(const std::string &filename) {
+    std::ifstream in(filename);
+    std::string line;
+    if (!std::getline(in, line) || line != Header)
+        return false;
+
+    std::vector<Entry> loaded;
+    long long at;
+    char letter;
+    while (in >> at >> letter) {
+        const char *c = std::strchr(Letters, letter);
+        if (!c || !*c || at < 0)
+            return false;
+        // Times never go backwards, whatever the file says
+        Entry e{std::chrono::nanoseconds(at),
+                static_cast<Command>(c - Letters)};
+        if (!loaded.empty())
+            e.at = std::max(e.at, loaded.back().at);
+        loaded.push_back(e);
+    }
+    if (!in.eof())
+        return false;
+    entries.swap(loaded);
+    return true;
+}
@@ -0,0 +1,387 @@
+#include "level_analysis.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+// Rooms bigger than this are left to the search; planning them would cost
+// more than it saves
+const size_t MaxRoomCells = 128;
+
+const uint8_t Vertical = 1;
+const uint8_t Horizontal = 2;
+
+uint8_t axis(Direction dir) {
+    return dir == Direction::UP || dir == Direction::DOWN ? Vertical
+                                                          : Horizontal;
+}
+
+// Cells reachable from `from` over allowed cells without boxes
+void reachable(const Layout &layout, uint32_t from, const uint8_t *boxes,
+               const std::vector<uint8_t> &allowed,
+               std::vector<uint8_t> &seen) {
+    thread_local std::vector<uint32_t> stack;
+    seen.assign(layout.cellCount(), 0);
+    seen[from] = 1;
+    stack.assign(1, from);
+    while (!stack.empty()) {
+        const uint32_t cell = stack.back();
+        stack.pop_back();
+        for (size_t d = 0; d < 4; ++d) {
+            const uint32_t next =
+                layout.neighbor(cell, static_cast<Direction>(d));
+            if (next != Layout::None && !seen[next] && allowed[next] &&
+                !Layout::hasBox(boxes, next)) {
+                seen[next] = 1;
+                stack.push_back(next);
+            }
+        }
+    }
+}
+} // namespace
+
+bool pushBoxTo(const Layout &layout, uint32_t player, const uint8_t *boxes,
+               uint32_t box, uint32_t target,
+               const std::vector<uint8_t> &allowed, std::vector<Push> &out) {
+    // Breadth-first over (box, player) where the player always stands
+    // where the box just was, so no normalization is needed
+    struct State {
+        uint32_t box;
+        uint32_t player;
+        uint32_t parent;
+        Direction dir;
+    };
+    const uint64_t n = layout.cellCount();
+    std::vector<uint8_t> work(boxes, boxes + layout.boxBytes());
+    std::vector<State> states(1, {box, player, UINT32_MAX, Direction::UP});
+    std::unordered_map<uint64_t, uint32_t> seen;
+    seen.emplace(box * n + player, 0);
+    std::vector<uint8_t> reach;
+
+    for (uint32_t i = 0; i < states.size(); ++i) {
+        const State s = states[i];
+        if (s.box == target) {
+            out.clear();
+            for (uint32_t j = i; states[j].parent != UINT32_MAX;
+                 j = states[j].parent) {
+                out.push_back({states[states[j].parent].box, states[j].dir});
+            }
+            std::reverse(out.begin(), out.end());
+            return true;
+        }
+        Layout::clearBox(work.data(), box);
+        Layout::setBox(work.data(), s.box);
+        reachable(layout, s.player, work.data(), allowed, reach);
+        Layout::clearBox(work.data(), s.box);
+        for (size_t d = 0; d < 4; ++d) {
+            const Direction dir = static_cast<Direction>(d);
+            const uint32_t behind = layout.neighbor(s.box, opposite(dir));
+            const uint32_t to = layout.neighbor(s.box, dir);
+            if (behind == Layout::None || !reach[behind] ||
+                to == Layout::None || !allowed[to] ||
+                Layout::hasBox(work.data(), to) || layout.isDead(to))
+                continue;
+            if (seen.emplace(to * n + s.box, states.size()).second)
+                states.push_back({to, s.box, i, dir});
+        }
+    }
+    return false;
+}
+
+LevelAnalysis::LevelAnalysis(const Layout &layout, const uint8_t *startBoxes)
+    : layout_(layout), tunnel_(layout.cellCount(), 0),
+      articulation_(layout.cellCount(), 0),
+      entranceOf_(layout.cellCount(), Layout::None),
+      roomOf_(layout.cellCount(), Layout::None) {
+    for (uint32_t cell = 0; cell < layout.cellCount(); ++cell) {
+        if (layout.neighbor(cell, Direction::LEFT) == Layout::None &&
+            layout.neighbor(cell, Direction::RIGHT) == Layout::None)
+            tunnel_[cell] |= Vertical;
+        if (layout.neighbor(cell, Direction::UP) == Layout::None &&
+            layout.neighbor(cell, Direction::DOWN) == Layout::None)
+            tunnel_[cell] |= Horizontal;
+    }
+    findArticulations();
+    findGoalRooms(startBoxes);
+}
+
+bool LevelAnalysis::isTunnel(uint32_t cell, Direction dir) const {
+    return tunnel_[cell] & axis(dir);
+}
+
+bool LevelAnalysis::isArticulation(uint32_t cell) const {
+    return articulation_[cell];
+}
+
+const std::vector<GoalRoom> &LevelAnalysis::goalRooms() const {
+    return rooms_;
+}
+
+size_t LevelAnalysis::tunnelCount() const {
+    return tunnel_.size() -
+           std::count(tunnel_.begin(), tunnel_.end(), uint8_t(0));
+}
+
+size_t LevelAnalysis::articulationCount() const {
+    return std::count(articulation_.begin(), articulation_.end(), 1);
+}
+
+void LevelAnalysis::findArticulations() {
+    // Tarjan's low-link, iteratively so big levels cannot blow the stack
+    const uint32_t n = static_cast<uint32_t>(layout_.cellCount());
+    std::vector<uint32_t> disc(n, Layout::None);
+    std::vector<uint32_t> low(n, 0);
+    std::vector<uint32_t> parent(n, Layout::None);
+    std::vector<std::pair<uint32_t, uint8_t>> stack;
+    uint32_t timer = 0;
+    for (uint32_t root = 0; root < n; ++root) {
+        if (disc[root] != Layout::None)
+            continue;
+        size_t rootChildren = 0;
+        disc[root] = low[root] = timer++;
+        stack.assign(1, {root, 0});
+        while (!stack.empty()) {
+            const uint32_t v = stack.back().first;
+            if (stack.back().second < 4) {
+                const Direction d =
+                    static_cast<Direction>(stack.back().second++);
+                const uint32_t u = layout_.neighbor(v, d);
+                if (u == Layout::None)
+                    continue;
+                if (disc[u] == Layout::None) {
+                    parent[u] = v;
+                    disc[u] = low[u] = timer++;
+                    rootChildren += v == root;
+                    stack.push_back({u, 0});
+                } else if (u != parent[v]) {
+                    low[v] = std::min(low[v], disc[u]);
+                }
+                continue;
+            }
+            stack.pop_back();
+            const uint32_t p = parent[v];
+            if (p == Layout::None)
+                continue;
+            low[p] = std::min(low[p], low[v]);
+            if (p != root && low[v] >= disc[p])
+                articulation_[p] = 1;
+        }
+        if (rootChildren > 1)
+            articulation_[root] = 1;
+    }
+}
+
+void LevelAnalysis::findGoalRooms(const uint8_t *startBoxes) {
+    const size_t n = layout_.cellCount();
+    std::vector<GoalRoom> candidates;
+    std::vector<uint32_t> label(n);
+    std::vector<uint32_t> stack;
+    for (uint32_t a = 0; a < n; ++a) {
+        if (!articulation_[a] || layout_.isGoal(a))
+            continue;
+        // Each side of the entrance is a candidate room
+        std::fill(label.begin(), label.end(), Layout::None);
+        label[a] = a;
+        for (size_t d = 0; d < 4; ++d) {
+            const uint32_t start =
+                layout_.neighbor(a, static_cast<Direction>(d));
+            if (start == Layout::None || label[start] != Layout::None)
+                continue;
+            GoalRoom room;
+            room.entrance = a;
+            bool goals = false;
+            bool boxes = false;
+            label[start] = start;
+            stack.assign(1, start);
+            while (!stack.empty()) {
+                const uint32_t cell = stack.back();
+                stack.pop_back();
+                room.cells.push_back(cell);
+                goals |= layout_.isGoal(cell);
+                boxes |= Layout::hasBox(startBoxes, cell);
+                for (size_t e = 0; e < 4; ++e) {
+                    const uint32_t next =
+                        layout_.neighbor(cell, static_cast<Direction>(e));
+                    if (next != Layout::None && label[next] == Layout::None) {
+                        label[next] = start;
+                        stack.push_back(next);
+                    }
+                }
+            }
+            if (goals && !boxes && room.cells.size() <= MaxRoomCells)
+                candidates.push_back(std::move(room));
+        }
+    }
+
+    // Biggest rooms first; nested and overlapping ones are skipped
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const GoalRoom &x, const GoalRoom &y) {
+                         return x.cells.size() > y.cells.size();
+                     });
+    for (GoalRoom &room : candidates) {
+        const bool taken =
+            entranceOf_[room.entrance] != Layout::None ||
+            roomOf_[room.entrance] != Layout::None ||
+            std::any_of(room.cells.begin(), room.cells.end(),
+                        [this](uint32_t c) {
+                            return roomOf_[c] != Layout::None ||
+                                   entranceOf_[c] != Layout::None;
+                        });
+        if (taken || !planRoom(room))
+            continue;
+        const uint32_t index = static_cast<uint32_t>(rooms_.size());
+        entranceOf_[room.entrance] = index;
+        for (uint32_t c : room.cells) {
+            roomOf_[c] = index;
+        }
+        rooms_.push_back(std::move(room));
+    }
+}
+
+bool LevelAnalysis::planRoom(GoalRoom &room) const {
+    const size_t n = layout_.cellCount();
+    const uint32_t a = room.entrance;
+    std::vector<uint8_t> inRoom(n, 0);
+    for (uint32_t c : room.cells) {
+        inRoom[c] = 1;
+    }
+    // The player may stand in the room, on the entrance, or just outside
+    // it where the box came from
+    std::vector<uint8_t> allowed(inRoom);
+    allowed[a] = 1;
+    for (size_t d = 0; d < 4; ++d) {
+        const uint32_t c = layout_.neighbor(a, static_cast<Direction>(d));
+        if (c != Layout::None)
+            allowed[c] = 1;
+    }
+
+    std::vector<uint32_t> remaining;
+    for (uint32_t c : room.cells) {
+        if (layout_.isGoal(c))
+            remaining.push_back(c);
+    }
+    std::vector<uint8_t> boxes(layout_.boxBytes(), 0);
+    std::vector<uint8_t> walk(inRoom);
+    walk[a] = 1;
+    std::vector<uint8_t> reach;
+    std::vector<Push> path;
+
+    while (!remaining.empty()) {
+        // Prefer the goal deepest in the room
+        std::vector<uint32_t> depth(n, 0);
+        {
+            std::vector<uint32_t> queue(1, a);
+            std::vector<uint8_t> seen(n, 0);
+            seen[a] = 1;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                const uint32_t cell = queue[head];
+                for (size_t d = 0; d < 4; ++d) {
+                    const uint32_t next =
+                        layout_.neighbor(cell, static_cast<Direction>(d));
+                    if (next != Layout::None && walk[next] && !seen[next] &&
+                        !Layout::hasBox(boxes.data(), next)) {
+                        seen[next] = 1;
+                        depth[next] = depth[cell] + 1;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+        std::stable_sort(remaining.begin(), remaining.end(),
+                         [&](uint32_t x, uint32_t y) {
+                             return depth[x] > depth[y];
+                         });
+
+        bool placed = false;
+        for (size_t i = 0; i < remaining.size() && !placed; ++i) {
+            const uint32_t goal = remaining[i];
+            // The other goals must stay reachable once this one is full
+            Layout::setBox(boxes.data(), goal);
+            reachable(layout_, a, boxes.data(), walk, reach);
+            bool open = true;
+            for (uint32_t other : remaining) {
+                open &= other == goal || reach[other];
+            }
+            Layout::clearBox(boxes.data(), goal);
+            if (!open)
+                continue;
+
+            std::vector<std::vector<Push>> paths(4);
+            std::vector<uint8_t> has(4, 0);
+            for (size_t d = 0; d < 4; ++d) {
+                const Direction dir = static_cast<Direction>(d);
+                const uint32_t from = layout_.neighbor(a, opposite(dir));
+                if (from == Layout::None || inRoom[from])
+                    continue;
+                Layout::setBox(boxes.data(), a);
+                has[d] = pushBoxTo(layout_, from, boxes.data(), a, goal,
+                                   allowed, paths[d]);
+                Layout::clearBox(boxes.data(), a);
+            }
+            if (std::find(has.begin(), has.end(), 1) == has.end())
+                continue;
+
+            room.fillOrder.push_back(goal);
+            for (size_t d = 0; d < 4; ++d) {
+                room.paths.push_back(std::move(paths[d]));
+                room.hasPath.push_back(has[d]);
+            }
+            Layout::setBox(boxes.data(), goal);
+            remaining.erase(remaining.begin() + i);
+            placed = true;
+        }
+        if (!placed)
+            return false;
+    }
+    return true;
+}
+
+bool LevelAnalysis::roomReady(const GoalRoom &room, const uint8_t *boxes,
+                              size_t &filled) const {
+    filled = 0;
+    for (uint32_t c : room.cells) {
+        filled += Layout::hasBox(boxes, c);
+    }
+    if (filled >= room.fillOrder.size())
+        return false;
+    for (size_t k = 0; k < filled; ++k) {
+        if (!Layout::hasBox(boxes, room.fillOrder[k]))
+            return false;
+    }
+    return true;
+}
+
+uint32_t LevelAnalysis::extend(uint8_t *boxes, const Push &push,
+                               std::vector<Push> &follow) const {
+    uint32_t player = push.box;
+    Push last = push;
+    for (;;) {
+        const uint32_t at = layout_.neighbor(last.box, last.dir);
+
+        // Into a goal room from outside: straight to the next goal
+        const uint32_t room = entranceOf_[at];
+        size_t filled;
+        if (room != Layout::None && roomOf_[last.box] != room &&
+            roomReady(rooms_[room], boxes, filled)) {
+            const size_t slot = filled * 4 + static_cast<size_t>(last.dir);
+            if (rooms_[room].hasPath[slot]) {
+                for (const Push &p : rooms_[room].paths[slot]) {
+                    player = layout_.applyPush(boxes, p);
+                    follow.push_back(p);
+                }
+                return player;
+            }
+        }
+
+        // Along a tunnel with the player in it too: on until it opens up
+        if (layout_.isGoal(at) || !isTunnel(at, last.dir) ||
+            !isTunnel(last.box, last.dir))
+            return player;
+        const uint32_t next = layout_.neighbor(at, last.dir);
+        if (next == Layout::None || Layout::hasBox(boxes, next) ||
+            layout_.isDead(next))
+            return player;
+        last = {at, last.dir};
+        player = layout_.applyPush(boxes, last);
+        follow.push_back(last);
+    }
+}
@@ -0,0 +1,237 @@
+#include "level_hash.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+using namespace Type;
+
+namespace {
+// Marks cells the player can reach while building an orientation
+const uint8_t Reach = 0x80;
+
+uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+uint64_t fmix(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+} // namespace
+
+std::string LevelHash::hex() const {
+    char buf[33];
+    std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+                  static_cast<unsigned long long>(hi),
+                  static_cast<unsigned long long>(lo));
+    return buf;
+}
+
+LevelHash hashBytes(const uint8_t *data, size_t size, uint64_t seed) {
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    const size_t blocks = size / 16;
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t k1, k2;
+        std::memcpy(&k1, data + i * 16, 8);
+        std::memcpy(&k2, data + i * 16 + 8, 8);
+
+        k1 *= c1;
+        k1 = rotl(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = rotl(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = rotl(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = rotl(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t *tail = data + blocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = size & 15; i > 8; --i) {
+        k2 ^= uint64_t(tail[i - 1]) << ((i - 9) * 8);
+    }
+    for (size_t i = std::min<size_t>(size & 15, 8); i > 0; --i) {
+        k1 ^= uint64_t(tail[i - 1]) << ((i - 1) * 8);
+    }
+    if (k2) {
+        k2 *= c2;
+        k2 = rotl(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+    if (k1) {
+        k1 *= c1;
+        k1 = rotl(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    h1 ^= size;
+    h2 ^= size;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+    h1 += h2;
+    h2 += h1;
+    return {h1, h2};
+}
+
+std::vector<uint8_t> canonicalForm(const Board &board) {
+    Board level = board;
+    level.normalize(); // Invalid levels are still hashed as they are
+    const size_t w = level.width();
+    const size_t h = level.height();
+
+    // Keep only what makes up the puzzle; the player becomes the set of
+    // cells it can walk to
+    std::vector<uint8_t> cells(w * h, Empty);
+    std::vector<size_t> stack;
+    for (size_t y = 0; y < h; ++y) {
+        for (size_t x = 0; x < w; ++x) {
+            const Flag f = level[y][x];
+            if (f == Empty)
+                continue;
+            if (f & Wall)
+                cells[y * w + x] = Wall;
+            else
+                cells[y * w + x] = Floor | (f & (Goal | Box));
+            if ((f & At) && stack.empty())
+                stack.push_back(y * w + x);
+        }
+    }
+    if (!stack.empty())
+        cells[stack.back()] |= Reach;
+    while (!stack.empty()) {
+        const size_t pos = stack.back();
+        stack.pop_back();
+        const size_t x = pos % w;
+        const size_t y = pos / w;
+        const size_t next[4][2] = {
+            {x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+        for (const auto &[nx, ny] : next) {
+            if (nx >= w || ny >= h)
+                continue;
+            uint8_t &c = cells[ny * w + nx];
+            if ((c & Floor) && !(c & (Box | Reach))) {
+                c |= Reach;
+                stack.push_back(ny * w + nx);
+            }
+        }
+    }
+
+    std::vector<uint8_t> best;
+    std::vector<uint8_t> form;
+    for (int s = 0; s < 8; ++s) {
+        const bool transpose = s & 4;
+        const size_t tw = transpose ? h : w;
+        const size_t th = transpose ? w : h;
+        form.assign(4 + tw * th, 0);
+        form[0] = tw & 0xFF;
+        form[1] = (tw >> 8) & 0xFF;
+        form[2] = th & 0xFF;
+        form[3] = (th >> 8) & 0xFF;
+
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x) {
+                const size_t fx = (s & 1) ? w - 1 - x : x;
+                const size_t fy = (s & 2) ? h - 1 - y : y;
+                const size_t tx = transpose ? fy : fx;
+                const size_t ty = transpose ? fx : fy;
+                form[4 + ty * tw + tx] = cells[y * w + x];
+            }
+        }
+
+        // The player stands on the first reachable cell of this orientation
+        bool placed = false;
+        for (size_t i = 4; i < form.size(); ++i) {
+            if (form[i] & Reach) {
+                form[i] &= ~Reach;
+                if (!placed)
+                    form[i] |= At;
+                placed = true;
+            }
+        }
+
+        if (best.empty() || form < best)
+            best.swap(form);
+    }
+    return best;
+}
+
+LevelHash levelHash(const Board &board) {
+    const std::vector<uint8_t> form = canonicalForm(board);
+    return hashBytes(form.data(), form.size());
+}
+
+LevelDeduper::LevelDeduper(size_t threads)
+    : threads_(std::max<size_t>(threads, 1)), duplicates_(0), failed_(0) {}
+
+std::vector<size_t>
+LevelDeduper::addFiles(const std::vector<std::string> &files,
+                       std::vector<LevelHash> *hashesOut) {
+    // Hash the whole batch in parallel...
+    std::vector<LevelHash> hashes(files.size());
+    std::vector<uint8_t> loaded(files.size(), 0);
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+        Board board;
+        for (size_t i = next++; i < files.size(); i = next++) {
+            // An exception escaping a worker would terminate the batch;
+            // count such a file as not loaded instead
+            try {
+                if (board.loadFromFile(files[i])) {
+                    hashes[i] = levelHash(board);
+                    loaded[i] = 1;
+                }
+            } catch (const std::exception &) {
+                loaded[i] = 0;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < std::min(threads_, files.size()); ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &t : pool) {
+        t.join();
+    }
+
+    // ...then keep first occurrences in input order
+    std::vector<size_t> unique;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!loaded[i])
+            failed_++;
+        else if (seen_.insert(hashes[i]).second)
+            unique.push_back(i);
+        else
+            duplicates_++;
+    }
+    if (hashesOut)
+        hashesOut->swap(hashes);
+    return unique;
+}
+
+size_t LevelDeduper::uniqueCount() const { return seen_.size(); }
+
+size_t LevelDeduper::duplicateCount() const { return duplicates_; }
+
+size_t LevelDeduper::failedCount() const { return failed_; }
@@ -0,0 +1,178 @@
+#include "load_client.hpp"
+#include "server.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Connection {
+    int fd = -1;
+    size_t sent = 0;
+    size_t answered = 0;
+    Clock::time_point batchStart;
+};
+
+int connectTo(const LoadConfig &config) {
+    int fd = -1;
+    if (!config.unixPath.empty()) {
+        struct sockaddr_un addr = {};
+        if (config.unixPath.size() >= sizeof(addr.sun_path))
+            return -1;
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return -1;
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, config.unixPath.c_str(),
+                    config.unixPath.size() + 1);
+        if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+            0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config.port);
+        if (inet_pton(AF_INET, config.address.c_str(), &addr.sin_addr) != 1)
+            return -1;
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return -1;
+        if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+            0) {
+            close(fd);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+} // namespace
+
+LoadResult runLoad(const LoadConfig &config) {
+    LoadResult result;
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<int> move(0, 3);
+    const size_t pipeline = std::max<size_t>(config.pipeline, 1);
+    std::vector<uint8_t> batch(pipeline);
+    double totalBatchMs = 0;
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        return result;
+
+    // Sends the next batch of random moves on c, false on a dead socket
+    auto sendBatch = [&](Connection &c) {
+        const size_t n =
+            std::min(pipeline, config.requestsPerSession - c.sent);
+        for (size_t i = 0; i < n; ++i) {
+            batch[i] = static_cast<uint8_t>(move(rng));
+        }
+        c.batchStart = Clock::now();
+        size_t off = 0;
+        while (off < n) {
+            ssize_t w = send(c.fd, batch.data() + off, n - off, MSG_NOSIGNAL);
+            if (w < 0) {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                return false;
+            }
+            off += w;
+        }
+        c.sent += n;
+        return true;
+    };
+
+    const auto start = Clock::now();
+    std::vector<Connection> conns;
+    conns.reserve(config.sessions);
+    for (size_t i = 0; i < config.sessions; ++i) {
+        Connection c;
+        c.fd = connectTo(config);
+        if (c.fd < 0)
+            break;
+        conns.push_back(c);
+    }
+    result.connected = conns.size();
+
+    size_t open = 0;
+    for (size_t i = 0; i < conns.size(); ++i) {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+        if (config.requestsPerSession > 0 && sendBatch(conns[i])) {
+            open++;
+        } else {
+            close(conns[i].fd);
+            conns[i].fd = -1;
+        }
+    }
+
+    std::vector<struct epoll_event> events(256);
+    uint8_t buf[4096];
+    while (open > 0) {
+        int n = epoll_wait(epollFd, events.data(),
+                           static_cast<int>(events.size()), 5000);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break; // Server went quiet
+
+        for (int i = 0; i < n; ++i) {
+            Connection &c = conns[events[i].data.u64];
+            if (c.fd < 0)
+                continue;
+            ssize_t r = read(c.fd, buf, sizeof(buf));
+            if (r <= 0) {
+                close(c.fd);
+                c.fd = -1;
+                open--;
+                continue;
+            }
+            result.answered += r;
+            c.answered += r;
+            result.invalid += std::count(buf, buf + r, Protocol::Invalid);
+
+            if (c.answered < c.sent)
+                continue;
+            const double ms = std::chrono::duration<double, std::milli>(
+                                  Clock::now() - c.batchStart)
+                                  .count();
+            result.batches++;
+            totalBatchMs += ms;
+            result.maxBatchMs = std::max(result.maxBatchMs, ms);
+
+            if (c.sent == config.requestsPerSession || !sendBatch(c)) {
+                close(c.fd);
+                c.fd = -1;
+                open--;
+            }
+        }
+    }
+
+    for (Connection &c : conns) {
+        if (c.fd >= 0)
+            close(c.fd);
+    }
+    close(epollFd);
+
+    result.seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    if (result.batches > 0)
+        result.meanBatchMs = totalBatchMs / result.batches;
+    return result;
+}
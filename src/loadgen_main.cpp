@@ -0,0 +1,55 @@
+#include <cstdlib>
+#include <iostream>
+#include <load_client.hpp>
+#include <string>
+#include <sys/resource.h>
+
+// Load generator for sokoban_server:
+//   sokoban_loadgen [--port N | --unix path] [--sessions N] [--requests N]
+//                   [--pipeline N]
+
+int main(int argc, char *argv[]) {
+    LoadConfig config;
+    config.port = 7777;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--port")
+            config.port = static_cast<uint16_t>(std::atoi(argv[i + 1]));
+        else if (arg == "--unix")
+            config.unixPath = argv[i + 1];
+        else if (arg == "--sessions")
+            config.sessions = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (arg == "--requests")
+            config.requestsPerSession = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (arg == "--pipeline")
+            config.pipeline = std::strtoul(argv[i + 1], nullptr, 10);
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    LoadResult result = runLoad(config);
+    std::cout << "Sessions:  " << result.connected << "/" << config.sessions
+              << std::endl;
+    std::cout << "Answers:   " << result.answered << " ("
+              << result.invalid << " invalid)" << std::endl;
+    std::cout << "Time:      " << result.seconds << " s ("
+              << (result.seconds > 0 ? result.answered / result.seconds : 0)
+              << " req/s)" << std::endl;
+    std::cout << "Batch RTT: mean " << result.meanBatchMs << " ms, max "
+              << result.maxBatchMs << " ms" << std::endl;
+
+    const size_t expected = result.connected * config.requestsPerSession;
+    return result.connected == config.sessions &&
+                   result.answered == expected && result.invalid == 0
+               ? 0
+               : 1;
+}
@@ -1,14 +1,26 @@
 #include <QApplication>
-#include <QLabel>
 
 #include <board.hpp>
+#include <board_widget.hpp>
 #include <game.hpp>
+#include <input_log.hpp>
+#include <iostream>
+#include <string>
+#include <terminal_input.hpp>
 #include <types.hpp>
 
+// Qt frontend: sokoban --qt [level.bin]
 int main1(int argc, char *argv[]) {
     QApplication app(argc, argv);
-    QLabel label("Hello, World from Qt6!");
-    label.show();
+    Game &game = Game::instance();
+    game.initialize();
+    if (argc > 2 && !game.loadLevel(argv[2])) {
+        return 1;
+    }
+    BoardWidget view(game);
+    view.setWindowTitle("Sokoban");
+    view.refresh();
+    view.show();
     return app.exec();
 }
 
@@ -28,11 +40,44 @@ int main2(int argc, char *argv[]) {
     return 0;
 }
 
+// Terminal frontend: sokoban [--level file] [--record inputs.log]
+// --record saves every input with its time, for sokoban_replay
 int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--qt") {
+        return main1(argc, argv);
+    }
+
+    std::string levelFile;
+    std::string recordFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--level" && i + 1 < argc)
+            levelFile = argv[++i];
+        else if (arg == "--record" && i + 1 < argc)
+            recordFile = argv[++i];
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
     // Initialize and run the game
     Game &game = Game::instance();
     if (game.initialize()) {
+        if (!levelFile.empty() && !game.loadLevel(levelFile))
+            return 1;
+        InputLog log;
+        if (!recordFile.empty())
+            game.recordInputs(&log);
+        TerminalInput input(game.inputQueue());
+        input.start();
         game.run();
+        input.stop();
+        game.recordInputs(nullptr);
+        if (!recordFile.empty() && !log.save(recordFile)) {
+            std::cerr << "Cannot write " << recordFile << std::endl;
+            return 1;
+        }
     }
     return 0;
 }
@@ -0,0 +1,67 @@
+#include <board.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <solution_optimizer.hpp>
+#include <string>
+#include <thread>
+
+// Solution optimizer:
+//   sokoban_optimize --level file [--solution file] [--time MS]
+//                    [--threads N] [--window N]
+// Reads a LURD solution from --solution or stdin and prints one with no
+// more moves and pushes; the counts before and after go to stderr.
+
+int main(int argc, char *argv[]) {
+    std::string levelFile;
+    std::string solutionFile;
+    OptimizerConfig config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--level" && i + 1 < argc)
+            levelFile = argv[++i];
+        else if (arg == "--solution" && i + 1 < argc)
+            solutionFile = argv[++i];
+        else if (arg == "--time" && i + 1 < argc)
+            config.time = std::chrono::milliseconds(
+                std::strtoull(argv[++i], nullptr, 10));
+        else if (arg == "--threads" && i + 1 < argc)
+            config.threads = std::max(1l, std::atol(argv[++i]));
+        else if (arg == "--window" && i + 1 < argc)
+            config.window = std::max(2l, std::atol(argv[++i]));
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (levelFile.empty()) {
+        std::cerr << "Usage: sokoban_optimize --level file" << std::endl;
+        return 1;
+    }
+
+    Board level;
+    if (!level.loadFromFile(levelFile)) {
+        std::cerr << "Cannot load level " << levelFile << std::endl;
+        return 1;
+    }
+    std::string lurd;
+    if (solutionFile.empty()) {
+        std::cin >> lurd;
+    } else {
+        std::ifstream in(solutionFile);
+        in >> lurd;
+    }
+
+    OptimizeResult result = optimizeSolution(level, lurd, config);
+    if (!result.valid) {
+        std::cerr << "The solution does not solve " << levelFile << std::endl;
+        return 2;
+    }
+    std::cerr << result.before.moves << "/" << result.before.pushes
+              << " -> " << result.after.moves << "/" << result.after.pushes
+              << " moves/pushes, " << result.improved << " windows in "
+              << result.rounds << " rounds" << std::endl;
+    std::cout << result.solution << std::endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "replay.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <streambuf>
+
+namespace {
+// Swallows rendered text after it has been formatted, so render cost is
+// measured without terminal I/O
+class DiscardBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        return n;
+    }
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+};
+
+const char BaselineHeader[] = "sokoban-frame-baseline 1";
+
+std::string regression(const char *name, double measured, double baseline,
+                       double limit) {
+    char buf[128];
+    std::snprintf(buf, sizeof(buf),
+                  "%s p99 %.1f us exceeds %.1f us (baseline %.1f us)", name,
+                  measured, limit, baseline);
+    return buf;
+}
+} // namespace
+
+ReplayClock::ReplayClock(Game &game, const InputLog &log)
+    : game_(game), log_(log), epoch_(), now_(epoch_), next_(0),
+      quitSent_(false) {}
+
+std::chrono::steady_clock::time_point ReplayClock::now() {
+    const auto &entries = log_.entries;
+    while (next_ < entries.size() && epoch_ + entries[next_].at <= now_) {
+        // A full queue waits for the next frame, as the input thread would
+        if (!game_.inputQueue().push(
+                {entries[next_].command, epoch_ + entries[next_].at}))
+            return now_;
+        next_++;
+    }
+    if (next_ == entries.size() && !quitSent_)
+        quitSent_ = game_.inputQueue().push({Command::QUIT, now_});
+    return now_;
+}
+
+void ReplayClock::sleepUntil(std::chrono::steady_clock::time_point t) {
+    now_ = std::max(now_, t);
+}
+
+size_t ReplayClock::delivered() const { return next_; }
+
+CostSummary summarize(std::vector<std::chrono::nanoseconds> samples) {
+    CostSummary s;
+    if (samples.empty())
+        return s;
+    std::sort(samples.begin(), samples.end());
+    // Nearest rank
+    auto at = [&](double p) {
+        const size_t rank = static_cast<size_t>(p * samples.size() + 0.999999);
+        const size_t i = std::min(std::max<size_t>(rank, 1), samples.size());
+        return samples[i - 1].count() / 1000.0;
+    };
+    s.p50 = at(0.50);
+    s.p99 = at(0.99);
+    s.max = samples.back().count() / 1000.0;
+    return s;
+}
+
+ReplayReport replaySession(const Board &level, const InputLog &log,
+                           size_t passes) {
+    ReplayReport report;
+    std::vector<std::chrono::nanoseconds> update, render, frame;
+    DiscardBuffer discard;
+    std::ostream out(&discard);
+
+    for (size_t pass = 0; pass < std::max<size_t>(passes, 1); ++pass) {
+        Board board = level;
+        Game game(board);
+        game.updateStateFromBoard();
+        ReplayClock clock(game, log);
+        std::vector<FrameCost> costs;
+        game.run(clock, out, &costs);
+
+        report.frames = costs.size();
+        report.inputs = clock.delivered();
+        report.completed = game.isLevelComplete();
+        for (const FrameCost &c : costs) {
+            update.push_back(c.update);
+            render.push_back(c.render);
+            frame.push_back(c.update + c.render);
+        }
+    }
+    report.update = summarize(std::move(update));
+    report.render = summarize(std::move(render));
+    report.frame = summarize(std::move(frame));
+    return report;
+}
+
+FrameBaseline FrameBaseline::fromReport(const ReplayReport &report) {
+    FrameBaseline b;
+    b.update = report.update.p99;
+    b.render = report.render.p99;
+    b.frame = report.frame.p99;
+    return b;
+}
+
+bool FrameBaseline::save(const std::string &filename) const {
+    std::ofstream out(filename, std::ios::trunc);
+    out << BaselineHeader << "\n"
+        << "update " << update << "\n"
+        << "render " << render << "\n"
+        << "frame " << frame << "\n";
+    out.flush();
+    return out.good();
+}
+
+bool FrameBaseline::load(const std::string &filename) {
+    std::ifstream in(filename);
+    std::string line;
+    if (!std::getline(in, line) || line != BaselineHeader)
+        return false;
+    FrameBaseline b;
+    std::string key;
+    double value;
+    size_t seen = 0;
+    while (in >> key >> value) {
+        if (key == "update")
+            b.update = value;
+        else if (key == "render")
+            b.render = value;
+        else if (key == "frame")
+            b.frame = value;
+        else
+            continue;
+        seen++;
+    }
+    if (seen < 3)
+        return false;
+    *this = b;
+    return true;
+}
+
+std::vector<std::string> checkBaseline(const ReplayReport &report,
+                                       const FrameBaseline &baseline,
+                                       const Tolerance &tolerance) {
+    std::vector<std::string> problems;
+    const struct {
+        const char *name;
+        double measured;
+        double baseline;
+    } checks[] = {{"update", report.update.p99, baseline.update},
+                  {"render", report.render.p99, baseline.render},
+                  {"frame", report.frame.p99, baseline.frame}};
+    for (const auto &c : checks) {
+        const double limit =
+            c.baseline * (1 + tolerance.ratio) + tolerance.slackMicros;
+        if (c.measured > limit)
+            problems.push_back(
+                regression(c.name, c.measured, c.baseline, limit));
+    }
+    return problems;
+}
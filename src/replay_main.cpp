@@ -0,0 +1,98 @@
+#include <board.hpp>
+#include <cstdlib>
+#include <game.hpp>
+#include <iostream>
+#include <replay.hpp>
+#include <string>
+
+// Frame-time regression check:
+//   sokoban_replay --inputs log [--level file] [--passes N]
+//                  [--baseline file] [--tolerance RATIO] [--slack US]
+//                  [--write-baseline file]
+// Replays a session recorded with `sokoban --record log` on a virtual
+// clock and prints p50/p99/max update and render costs. With --baseline
+// it exits with 3 if any p99 is out of tolerance.
+
+namespace {
+void printSummary(const char *name, const CostSummary &s) {
+    std::cout << name << ": p50 " << s.p50 << " us, p99 " << s.p99
+              << " us, max " << s.max << " us" << std::endl;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string inputsFile;
+    std::string levelFile;
+    std::string baselineFile;
+    std::string writeBaseline;
+    size_t passes = 20;
+    Tolerance tolerance;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--inputs" && i + 1 < argc)
+            inputsFile = argv[++i];
+        else if (arg == "--level" && i + 1 < argc)
+            levelFile = argv[++i];
+        else if (arg == "--passes" && i + 1 < argc)
+            passes = std::max(1l, std::atol(argv[++i]));
+        else if (arg == "--baseline" && i + 1 < argc)
+            baselineFile = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc)
+            tolerance.ratio = std::atof(argv[++i]);
+        else if (arg == "--slack" && i + 1 < argc)
+            tolerance.slackMicros = std::atof(argv[++i]);
+        else if (arg == "--write-baseline" && i + 1 < argc)
+            writeBaseline = argv[++i];
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (inputsFile.empty()) {
+        std::cerr << "Usage: sokoban_replay --inputs log" << std::endl;
+        return 1;
+    }
+
+    InputLog log;
+    if (!log.load(inputsFile)) {
+        std::cerr << "Cannot load inputs " << inputsFile << std::endl;
+        return 1;
+    }
+    // Sessions without a level play the one Game::initialize builds
+    Board level;
+    Game game(level);
+    if (levelFile.empty() ? !game.initialize() : !game.loadLevel(levelFile)) {
+        std::cerr << "Cannot load level " << levelFile << std::endl;
+        return 1;
+    }
+
+    const ReplayReport report = replaySession(level, log, passes);
+    std::cout << report.frames << " frames, " << report.inputs
+              << " inputs per pass, level "
+              << (report.completed ? "completed" : "not completed")
+              << std::endl;
+    printSummary("update", report.update);
+    printSummary("render", report.render);
+    printSummary("frame", report.frame);
+
+    if (!writeBaseline.empty() &&
+        !FrameBaseline::fromReport(report).save(writeBaseline)) {
+        std::cerr << "Cannot write " << writeBaseline << std::endl;
+        return 1;
+    }
+    if (!baselineFile.empty()) {
+        FrameBaseline baseline;
+        if (!baseline.load(baselineFile)) {
+            std::cerr << "Cannot load baseline " << baselineFile << std::endl;
+            return 1;
+        }
+        const std::vector<std::string> problems =
+            checkBaseline(report, baseline, tolerance);
+        for (const std::string &problem : problems) {
+            std::cerr << problem << std::endl;
+        }
+        if (!problems.empty())
+            return 3;
+    }
+    return 0;
+}
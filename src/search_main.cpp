@@ -0,0 +1,70 @@
+#include <board.hpp>
+#include <cstdlib>
+#include <external_search.hpp>
+#include <iostream>
+#include <string>
+
+// Out-of-core solver:
+//   sokoban_search --level file --work dir [--mem MB] [--max-depth N]
+//                  [--fresh]
+// Layers and checkpoints live in the work directory; running the same
+// command again after an interruption resumes from the last layer.
+
+int main(int argc, char *argv[]) {
+    std::string levelFile;
+    ExternalSearchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--level" && i + 1 < argc)
+            levelFile = argv[++i];
+        else if (arg == "--work" && i + 1 < argc)
+            config.workDir = argv[++i];
+        else if (arg == "--mem" && i + 1 < argc)
+            config.memoryBytes = std::strtoull(argv[++i], nullptr, 10) << 20;
+        else if (arg == "--max-depth" && i + 1 < argc)
+            config.maxDepth = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--fresh")
+            config.resume = false;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (levelFile.empty() || config.workDir.empty()) {
+        std::cerr << "Usage: sokoban_search --level file --work dir"
+                  << std::endl;
+        return 1;
+    }
+
+    Board level;
+    if (!level.loadFromFile(levelFile)) {
+        std::cerr << "Cannot load level " << levelFile << std::endl;
+        return 1;
+    }
+    LevelCheck check = level.normalize();
+    for (const std::string &problem : check.problems) {
+        std::cerr << levelFile << ": " << problem << std::endl;
+    }
+    if (!check.valid())
+        return 1;
+
+    ExternalSearch search(level, config);
+    ExternalSearchResult result = search.run();
+    if (result.resumed)
+        std::cerr << "Resumed from checkpoint" << std::endl;
+    std::cerr << result.states << " states, " << result.depth << " layers, "
+              << result.runs << " runs, " << result.diskBytes
+              << " bytes on disk" << std::endl;
+
+    if (result.solved) {
+        std::cout << result.solution << std::endl;
+        return 0;
+    }
+    if (result.ioError) {
+        std::cerr << "I/O error in " << config.workDir << std::endl;
+        return 3;
+    }
+    std::cerr << (result.exhausted ? "No solution" : "Not solved yet")
+              << std::endl;
+    return 2;
+}
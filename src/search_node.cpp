@@ -0,0 +1,288 @@
+#include "search_node.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace Type;
+
+namespace {
+const size_t HeaderBytes = 8;
+
+bool walkable(Flag f) { return f != Empty && !(f & Wall); }
+} // namespace
+
+Layout::Layout(const Board &board)
+    : width_(board.width()), height_(board.height()),
+      cellOf_(width_ * height_, None) {
+    // Flood fill from the player; without one, index every walkable cell
+    std::vector<uint32_t> stack;
+    for (size_t y = 0; y < height_ && stack.empty(); ++y) {
+        for (size_t x = 0; x < width_; ++x) {
+            if ((board[y][x] & At) && walkable(board[y][x])) {
+                stack.push_back(static_cast<uint32_t>(y * width_ + x));
+                break;
+            }
+        }
+    }
+    std::vector<uint8_t> seen(width_ * height_, 0);
+    if (stack.empty()) {
+        for (size_t y = 0; y < height_; ++y) {
+            for (size_t x = 0; x < width_; ++x) {
+                seen[y * width_ + x] = walkable(board[y][x]);
+            }
+        }
+    } else {
+        seen[stack.back()] = 1;
+        while (!stack.empty()) {
+            const uint32_t pos = stack.back();
+            stack.pop_back();
+            const size_t x = pos % width_;
+            const size_t y = pos / width_;
+            const size_t next[4][2] = {
+                {x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+            for (const auto &[nx, ny] : next) {
+                // Unsigned wrap-around takes care of the left/top edges
+                if (nx >= width_ || ny >= height_)
+                    continue;
+                const size_t npos = ny * width_ + nx;
+                if (!seen[npos] && walkable(board[ny][nx])) {
+                    seen[npos] = 1;
+                    stack.push_back(static_cast<uint32_t>(npos));
+                }
+            }
+        }
+    }
+
+    // Row-major numbering keeps neighbours close in the box bitset
+    for (size_t pos = 0; pos < seen.size(); ++pos) {
+        if (!seen[pos])
+            continue;
+        const uint32_t cell = static_cast<uint32_t>(position_.size());
+        cellOf_[pos] = cell;
+        position_.push_back(static_cast<uint32_t>(pos));
+        const bool goal = board[pos / width_][pos % width_] & Goal;
+        isGoal_.push_back(goal);
+        if (goal)
+            goals_.push_back(cell);
+    }
+
+    neighbors_.assign(position_.size() * 4, None);
+    for (uint32_t cell = 0; cell < position_.size(); ++cell) {
+        const size_t x = cellX(cell);
+        const size_t y = cellY(cell);
+        neighbors_[cell * 4 + 0] = cellAt(x, y - 1);
+        neighbors_[cell * 4 + 1] = cellAt(x, y + 1);
+        neighbors_[cell * 4 + 2] = cellAt(x - 1, y);
+        neighbors_[cell * 4 + 3] = cellAt(x + 1, y);
+    }
+
+    goalBits_.assign(boxBytes(), 0);
+    for (uint32_t goal : goals_) {
+        setBox(goalBits_.data(), goal);
+    }
+
+    // Pull a box backwards from every goal; cells it never reaches are dead
+    isDead_.assign(position_.size(), 1);
+    stack.assign(goals_.begin(), goals_.end());
+    for (uint32_t goal : goals_) {
+        isDead_[goal] = 0;
+    }
+    while (!stack.empty()) {
+        const uint32_t cell = stack.back();
+        stack.pop_back();
+        for (size_t d = 0; d < 4; ++d) {
+            // The box came from `from`, pushed by a player standing behind
+            const Direction back = opposite(static_cast<Direction>(d));
+            const uint32_t from = neighbor(cell, back);
+            if (from == None || !isDead_[from] || neighbor(from, back) == None)
+                continue;
+            isDead_[from] = 0;
+            stack.push_back(from);
+        }
+    }
+}
+
+size_t Layout::width() const { return width_; }
+
+size_t Layout::height() const { return height_; }
+
+size_t Layout::cellCount() const { return position_.size(); }
+
+uint32_t Layout::cellAt(size_t x, size_t y) const {
+    if (x >= width_ || y >= height_)
+        return None;
+    return cellOf_[y * width_ + x];
+}
+
+size_t Layout::cellX(uint32_t cell) const { return position_[cell] % width_; }
+
+size_t Layout::cellY(uint32_t cell) const { return position_[cell] / width_; }
+
+uint32_t Layout::neighbor(uint32_t cell, Direction dir) const {
+    return neighbors_[cell * 4 + static_cast<size_t>(dir)];
+}
+
+bool Layout::isGoal(uint32_t cell) const { return isGoal_[cell]; }
+
+const std::vector<uint32_t> &Layout::goals() const { return goals_; }
+
+bool Layout::isDead(uint32_t cell) const { return isDead_[cell]; }
+
+size_t Layout::boxBytes() const {
+    return std::max<size_t>((position_.size() + 7) / 8, 1);
+}
+
+bool Layout::encode(const Board &board, uint32_t &player,
+                    uint8_t *boxes) const {
+    std::memset(boxes, 0, boxBytes());
+    player = None;
+    for (size_t y = 0; y < height_; ++y) {
+        const std::vector<Flag> &row = board[y];
+        for (size_t x = 0; x < width_; ++x) {
+            if (!(row[x] & (At | Box)))
+                continue;
+            const uint32_t cell = cellAt(x, y);
+            if (cell == None)
+                return false;
+            if (row[x] & Box)
+                setBox(boxes, cell);
+            if (row[x] & At)
+                player = cell;
+        }
+    }
+    return player != None;
+}
+
+void Layout::decode(uint32_t player, const uint8_t *boxes,
+                    Board &board) const {
+    for (uint32_t cell = 0; cell < position_.size(); ++cell) {
+        Flag &f = board[cellY(cell)][cellX(cell)];
+        f &= ~(At | Box);
+        if (hasBox(boxes, cell))
+            f |= Box;
+        if (cell == player)
+            f |= At;
+    }
+}
+
+uint32_t Layout::normalizePlayer(uint32_t player,
+                                 const uint8_t *boxes) const {
+    thread_local std::vector<uint32_t> stack;
+    thread_local std::vector<uint8_t> seen;
+    seen.assign(position_.size(), 0);
+    stack.assign(1, player);
+    seen[player] = 1;
+
+    uint32_t best = player;
+    while (!stack.empty()) {
+        const uint32_t cell = stack.back();
+        stack.pop_back();
+        best = std::min(best, cell);
+        for (size_t d = 0; d < 4; ++d) {
+            const uint32_t next = neighbors_[cell * 4 + d];
+            if (next != None && !seen[next] && !hasBox(boxes, next)) {
+                seen[next] = 1;
+                stack.push_back(next);
+            }
+        }
+    }
+    return best;
+}
+
+void Layout::pushes(uint32_t player, const uint8_t *boxes,
+                    std::vector<Push> &out) const {
+    thread_local std::vector<uint32_t> stack;
+    thread_local std::vector<uint8_t> seen;
+    seen.assign(position_.size(), 0);
+    stack.assign(1, player);
+    seen[player] = 1;
+    out.clear();
+
+    while (!stack.empty()) {
+        const uint32_t cell = stack.back();
+        stack.pop_back();
+        for (size_t d = 0; d < 4; ++d) {
+            const uint32_t next = neighbors_[cell * 4 + d];
+            if (next == None)
+                continue;
+            if (!hasBox(boxes, next)) {
+                if (!seen[next]) {
+                    seen[next] = 1;
+                    stack.push_back(next);
+                }
+                continue;
+            }
+            const uint32_t target = neighbors_[next * 4 + d];
+            if (target != None && !hasBox(boxes, target) && !isDead_[target])
+                out.push_back({next, static_cast<Direction>(d)});
+        }
+    }
+}
+
+uint32_t Layout::applyPush(uint8_t *boxes, const Push &push) const {
+    clearBox(boxes, push.box);
+    setBox(boxes, neighbor(push.box, push.dir));
+    return push.box;
+}
+
+bool Layout::isSolved(const uint8_t *boxes) const {
+    for (size_t i = 0; i < goalBits_.size(); ++i) {
+        if (boxes[i] & ~goalBits_[i])
+            return false;
+    }
+    return true;
+}
+
+NodeStore::NodeStore(const Layout &layout, size_t chunkNodes)
+    : boxBytes_(layout.boxBytes()),
+      stride_((HeaderBytes + boxBytes_ + 3) & ~size_t(3)),
+      chunkNodes_(std::max<size_t>(chunkNodes, 1)),
+      arena_(chunkNodes_ * stride_ + alignof(uint32_t)), size_(0) {}
+
+uint8_t *NodeStore::at(uint32_t node) const {
+    return chunks_[node / chunkNodes_] + (node % chunkNodes_) * stride_;
+}
+
+uint32_t NodeStore::add(uint32_t parent, uint32_t player, uint8_t move,
+                        const uint8_t *boxes) {
+    if (size_ % chunkNodes_ == 0 && size_ / chunkNodes_ == chunks_.size()) {
+        chunks_.push_back(arena_.allocateArray<uint8_t>(chunkNodes_ * stride_));
+    }
+    const uint32_t node = static_cast<uint32_t>(size_++);
+    uint8_t *p = at(node);
+    std::memcpy(p, &parent, sizeof(parent));
+    p[4] = static_cast<uint8_t>(player);
+    p[5] = static_cast<uint8_t>(player >> 8);
+    p[6] = static_cast<uint8_t>(player >> 16);
+    p[7] = move;
+    std::memcpy(p + HeaderBytes, boxes, boxBytes_);
+    return node;
+}
+
+uint32_t NodeStore::parent(uint32_t node) const {
+    uint32_t parent;
+    std::memcpy(&parent, at(node), sizeof(parent));
+    return parent;
+}
+
+uint32_t NodeStore::player(uint32_t node) const {
+    const uint8_t *p = at(node);
+    return p[4] | (uint32_t(p[5]) << 8) | (uint32_t(p[6]) << 16);
+}
+
+uint8_t NodeStore::move(uint32_t node) const { return at(node)[7]; }
+
+const uint8_t *NodeStore::boxes(uint32_t node) const {
+    return at(node) + HeaderBytes;
+}
+
+size_t NodeStore::size() const { return size_; }
+
+size_t NodeStore::nodeBytes() const { return stride_; }
+
+size_t NodeStore::bytesReserved() const { return arena_.bytesReserved(); }
+
+void NodeStore::clear() {
+    arena_.reset();
+    chunks_.clear();
+    size_ = 0;
+}
@@ -0,0 +1,340 @@
+#include "server.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+const size_t ReadChunk = 4096;
+const int MaxEvents = 256;
+// Stop reading from a client whose answers pile up faster than it reads
+const size_t MaxPendingOut = 64 * 1024;
+} // namespace
+
+Server::Session::Session(const Board &level)
+    : board(level), game(board, Game::Input::None) {
+    game.updateStateFromBoard();
+}
+
+Server::Server(const Board &level)
+    : level_(level), epollFd_(epoll_create1(EPOLL_CLOEXEC)),
+      wakeFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), tcpFd_(-1),
+      unixFd_(-1), port_(0), accepting_(true), sessionCount_(0) {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeFd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+}
+
+Server::~Server() {
+    for (size_t fd = 0; fd < sessions_.size(); ++fd) {
+        if (sessions_[fd])
+            close(static_cast<int>(fd));
+    }
+    if (tcpFd_ >= 0)
+        close(tcpFd_);
+    if (unixFd_ >= 0) {
+        close(unixFd_);
+        unlink(unixPath_.c_str());
+    }
+    close(wakeFd_);
+    close(epollFd_);
+}
+
+bool Server::listenTcp(uint16_t port, const std::string &address) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1 ||
+        bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    tcpFd_ = fd;
+    return true;
+}
+
+bool Server::listenUnix(const std::string &path) {
+    struct sockaddr_un addr = {};
+    if (path.size() >= sizeof(addr.sun_path))
+        return false;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return false;
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    unixFd_ = fd;
+    unixPath_ = path;
+    return true;
+}
+
+uint16_t Server::port() const { return port_; }
+
+size_t Server::sessionCount() const { return sessionCount_; }
+
+void Server::setAcceptHook(AcceptHook accept) { accept_ = std::move(accept); }
+
+void Server::stop() {
+    uint64_t one = 1;
+    ssize_t n = write(wakeFd_, &one, sizeof(one));
+    (void)n;
+}
+
+void Server::run() {
+    struct epoll_event events[MaxEvents];
+
+    while (true) {
+        int n = epoll_wait(epollFd_, events, MaxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd_) {
+                uint64_t count;
+                ssize_t r = read(wakeFd_, &count, sizeof(count));
+                (void)r;
+                return;
+            }
+            if (fd == tcpFd_ || fd == unixFd_) {
+                acceptAll(fd);
+                continue;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                // Still answer whatever the client sent before hanging up
+                onReadable(fd);
+                closeSession(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+                onWritable(fd);
+            if (events[i].events & EPOLLIN)
+                onReadable(fd);
+        }
+    }
+}
+
+void Server::acceptAll(int listenFd) {
+    while (true) {
+        int fd = accept_ ? accept_(listenFd)
+                         : accept4(listenFd, nullptr, nullptr,
+                                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            // Out of descriptors: the listener stays readable, so stop
+            // watching it until closeSession frees one instead of spinning
+            if (errno == EMFILE || errno == ENFILE)
+                watchListeners(false);
+            return;
+        }
+
+        if (listenFd == tcpFd_) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        if (static_cast<size_t>(fd) >= sessions_.size())
+            sessions_.resize(fd + 1);
+        sessions_[fd] = std::make_unique<Session>(level_);
+        sessionCount_++;
+
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void Server::onReadable(int fd) {
+    if (static_cast<size_t>(fd) >= sessions_.size() || !sessions_[fd])
+        return;
+    Session &session = *sessions_[fd];
+
+    // Largest answer one request can queue: a State snapshot
+    const size_t maxAnswer =
+        4 + session.board.width() * session.board.height();
+    uint8_t buf[ReadChunk];
+    bool eof = false;
+    // Bounded per wakeup so one chatty client cannot starve the loop
+    while (session.out.size() - session.outPos < MaxPendingOut) {
+        // Read only as many requests as the room left under MaxPendingOut
+        // can answer, but at least one so huge boards are still served
+        const size_t room = MaxPendingOut - (session.out.size() -
+                                             session.outPos);
+        const size_t want =
+            std::clamp(room / maxAnswer, size_t(1), sizeof(buf));
+        ssize_t n = read(fd, buf, want);
+        if (n > 0) {
+            for (ssize_t i = 0; i < n; ++i) {
+                handleRequest(session, buf[i]);
+            }
+            if (static_cast<size_t>(n) < want)
+                break;
+        } else if (n == 0) {
+            eof = true;
+            break;
+        } else {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                eof = true;
+            break;
+        }
+    }
+
+    // One write for everything answered above
+    if (!flush(fd, session) || eof) {
+        closeSession(fd);
+        return;
+    }
+    updateInterest(fd, session);
+}
+
+void Server::onWritable(int fd) {
+    if (static_cast<size_t>(fd) >= sessions_.size() || !sessions_[fd])
+        return;
+    Session &session = *sessions_[fd];
+    if (!flush(fd, session)) {
+        closeSession(fd);
+        return;
+    }
+    updateInterest(fd, session);
+}
+
+void Server::handleRequest(Session &session, uint8_t request) {
+    Game &game = session.game;
+
+    if (request <= static_cast<uint8_t>(Direction::RIGHT)) {
+        game.clearDirtyCells();
+        uint8_t answer = 0;
+        if (game.movePlayer(static_cast<Direction>(request))) {
+            answer |= Protocol::Moved;
+            // A push touches three cells, a plain step two
+            if (game.dirtyCells().size() > 2)
+                answer |= Protocol::Pushed;
+        }
+        if (game.isLevelComplete())
+            answer |= Protocol::Complete;
+        session.out.push_back(answer);
+        return;
+    }
+
+    switch (request) {
+    case Protocol::Reset:
+        session.board = level_;
+        game.updateStateFromBoard();
+        session.out.push_back(game.isLevelComplete() ? Protocol::Complete
+                                                     : 0);
+        break;
+    case Protocol::State: {
+        const Board &board = session.board;
+        const uint16_t w = static_cast<uint16_t>(board.width());
+        const uint16_t h = static_cast<uint16_t>(board.height());
+        session.out.push_back(w & 0xFF);
+        session.out.push_back(w >> 8);
+        session.out.push_back(h & 0xFF);
+        session.out.push_back(h >> 8);
+        for (size_t y = 0; y < h; ++y) {
+            session.out.insert(session.out.end(), board[y].begin(),
+                               board[y].end());
+        }
+        break;
+    }
+    default:
+        session.out.push_back(Protocol::Invalid);
+        break;
+    }
+}
+
+bool Server::flush(int fd, Session &session) {
+    while (session.outPos < session.out.size()) {
+        ssize_t n = send(fd, session.out.data() + session.outPos,
+                         session.out.size() - session.outPos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        session.outPos += n;
+    }
+    session.out.clear();
+    session.outPos = 0;
+    return true;
+}
+
+void Server::updateInterest(int fd, Session &session) {
+    const size_t pending = session.out.size() - session.outPos;
+    const bool wantWrite = pending > 0;
+    if (wantWrite == session.wantWrite)
+        return;
+    session.wantWrite = wantWrite;
+
+    // While answers are stuck, only wait for the client to drain them
+    struct epoll_event ev = {};
+    ev.events = wantWrite ? EPOLLOUT : EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void Server::closeSession(int fd) {
+    if (static_cast<size_t>(fd) >= sessions_.size() || !sessions_[fd])
+        return;
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    sessions_[fd].reset();
+    sessionCount_--;
+    watchListeners(true);
+}
+
+void Server::watchListeners(bool watch) {
+    if (watch == accepting_)
+        return;
+    accepting_ = watch;
+    for (int fd : {tcpFd_, unixFd_}) {
+        if (fd < 0)
+            continue;
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd_, watch ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, fd, &ev);
+    }
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <board.hpp>
+#include <csignal>
+#include <cstdlib>
+#include <game.hpp>
+#include <iostream>
+#include <memory>
+#include <server.hpp>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+// Headless game server:
+//   sokoban_server [--level file] [--port N] [--unix path] [--threads N]
+// Each thread runs its own epoll loop; TCP connections are spread over the
+// loops by the kernel (SO_REUSEPORT), a Unix socket is served by the first.
+
+namespace {
+std::vector<std::unique_ptr<Server>> servers;
+
+void onSignal(int) {
+    for (auto &server : servers) {
+        server->stop();
+    }
+}
+
+// Ten thousand sessions need more descriptors than the usual soft limit
+void raiseFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string levelFile;
+    std::string unixPath;
+    int port = -1;
+    int threads = 1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--level")
+            levelFile = argv[i + 1];
+        else if (arg == "--port")
+            port = std::atoi(argv[i + 1]);
+        else if (arg == "--unix")
+            unixPath = argv[i + 1];
+        else if (arg == "--threads")
+            threads = std::max(1, std::atoi(argv[i + 1]));
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (port < 0 && unixPath.empty())
+        port = 7777;
+
+    // Sessions start from this board; the default is Game's built-in level
+    Board level;
+    if (levelFile.empty()) {
+        Game(level).initialize();
+    } else if (!level.loadFromFile(levelFile)) {
+        std::cerr << "Cannot load level " << levelFile << std::endl;
+        return 1;
+    } else {
+        LevelCheck check = level.normalize();
+        for (const std::string &problem : check.problems) {
+            std::cerr << levelFile << ": " << problem << std::endl;
+        }
+        if (!check.valid())
+            return 1;
+    }
+
+    raiseFileLimit();
+    for (int i = 0; i < threads; ++i) {
+        auto server = std::make_unique<Server>(level);
+        if (port >= 0 && !server->listenTcp(static_cast<uint16_t>(port))) {
+            std::cerr << "Cannot listen on port " << port << std::endl;
+            return 1;
+        }
+        if (i == 0 && !unixPath.empty() && !server->listenUnix(unixPath)) {
+            std::cerr << "Cannot listen on " << unixPath << std::endl;
+            return 1;
+        }
+        if (i == 0 && port == 0)
+            port = server->port(); // Share the picked port with the others
+        servers.push_back(std::move(server));
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::cout << "Serving on";
+    if (port >= 0)
+        std::cout << " 127.0.0.1:" << port;
+    if (!unixPath.empty())
+        std::cout << " " << unixPath;
+    std::cout << " with " << threads << " loop(s)" << std::endl;
+
+    std::vector<std::thread> loops;
+    for (size_t i = 1; i < servers.size(); ++i) {
+        loops.emplace_back(&Server::run, servers[i].get());
+    }
+    servers[0]->run();
+    for (auto &loop : loops) {
+        loop.join();
+    }
+    return 0;
+}
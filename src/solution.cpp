@@ -0,0 +1,108 @@
+#include "solution.hpp"
+#include "game.hpp"
+#include <algorithm>
+#include <cctype>
+
+char lurdChar(Direction dir, bool push) {
+    static const char steps[] = "udlr";
+    const char c = steps[static_cast<size_t>(dir)];
+    return push ? static_cast<char>(std::toupper(c)) : c;
+}
+
+SolutionCheck verifySolution(const Board &level, const std::string &lurd) {
+    SolutionCheck check;
+    Board board = level;
+    Game game(board);
+    game.updateStateFromBoard();
+
+    for (char c : lurd) {
+        Direction dir;
+        switch (std::tolower(c)) {
+        case 'u':
+            dir = Direction::UP;
+            break;
+        case 'd':
+            dir = Direction::DOWN;
+            break;
+        case 'l':
+            dir = Direction::LEFT;
+            break;
+        case 'r':
+            dir = Direction::RIGHT;
+            break;
+        default:
+            return check;
+        }
+
+        game.clearDirtyCells();
+        if (!game.movePlayer(dir))
+            return check;
+        check.moves++;
+        // A push touches three cells, a plain step two
+        const bool pushed = game.dirtyCells().size() > 2;
+        if (pushed)
+            check.pushes++;
+        // The case must say whether this move pushes
+        if (pushed != (std::isupper(static_cast<unsigned char>(c)) != 0))
+            return check;
+    }
+    check.solved = game.isLevelComplete();
+    return check;
+}
+
+bool walkPath(const Layout &layout, uint32_t from, uint32_t to,
+              const uint8_t *boxes, std::string &path) {
+    path.clear();
+    if (from == to)
+        return true;
+
+    // Breadth-first so the walk is as short as possible
+    std::vector<uint32_t> cameFrom(layout.cellCount(), Layout::None);
+    std::vector<uint32_t> queue(1, from);
+    cameFrom[from] = from;
+    for (size_t head = 0; head < queue.size() && cameFrom[to] == Layout::None;
+         ++head) {
+        const uint32_t cell = queue[head];
+        for (size_t d = 0; d < 4; ++d) {
+            const uint32_t next =
+                layout.neighbor(cell, static_cast<Direction>(d));
+            if (next != Layout::None && cameFrom[next] == Layout::None &&
+                !Layout::hasBox(boxes, next)) {
+                cameFrom[next] = cell;
+                queue.push_back(next);
+            }
+        }
+    }
+    if (cameFrom[to] == Layout::None)
+        return false;
+
+    for (uint32_t cell = to; cell != from; cell = cameFrom[cell]) {
+        const uint32_t prev = cameFrom[cell];
+        for (size_t d = 0; d < 4; ++d) {
+            if (layout.neighbor(prev, static_cast<Direction>(d)) == cell) {
+                path += lurdChar(static_cast<Direction>(d), false);
+                break;
+            }
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+bool pushesToLurd(const Layout &layout, uint32_t player,
+                  std::vector<uint8_t> boxes, const std::vector<Push> &pushes,
+                  std::string &lurd) {
+    lurd.clear();
+    std::string walk;
+    for (const Push &push : pushes) {
+        // Stand behind the box, then push
+        const uint32_t behind = layout.neighbor(push.box, opposite(push.dir));
+        if (behind == Layout::None ||
+            !walkPath(layout, player, behind, boxes.data(), walk))
+            return false;
+        lurd += walk;
+        lurd += lurdChar(push.dir, true);
+        player = layout.applyPush(boxes.data(), push);
+    }
+    return true;
+}
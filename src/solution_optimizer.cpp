@@ -0,0 +1,290 @@
+#include "solution_optimizer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// A window gives up beyond this many states or on the deadline, checked
+// every CheckInterval expansions
+const size_t MaxWindowNodes = 1 << 20;
+const size_t CheckInterval = 256;
+
+// Ordered by moves, then pushes
+struct Cost {
+    size_t moves = 0;
+    size_t pushes = 0;
+
+    bool operator<(const Cost &other) const {
+        return moves != other.moves ? moves < other.moves
+                                    : pushes < other.pushes;
+    }
+};
+
+// Where the player stands and the boxes are before a given push
+struct Waypoint {
+    uint32_t player;
+    std::vector<uint8_t> boxes;
+};
+
+// Walk lengths from `from` to every cell around the boxes
+void walkDistances(const Layout &layout, uint32_t from, const uint8_t *boxes,
+                   std::vector<uint32_t> &dist) {
+    thread_local std::vector<uint32_t> queue;
+    dist.assign(layout.cellCount(), Layout::None);
+    dist[from] = 0;
+    queue.assign(1, from);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t cell = queue[head];
+        for (size_t d = 0; d < 4; ++d) {
+            const uint32_t next =
+                layout.neighbor(cell, static_cast<Direction>(d));
+            if (next != Layout::None && dist[next] == Layout::None &&
+                !Layout::hasBox(boxes, next)) {
+                dist[next] = dist[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+std::vector<Waypoint> waypoints(const Layout &layout, const Waypoint &start,
+                                const std::vector<Push> &pushes) {
+    std::vector<Waypoint> out(1, start);
+    for (const Push &p : pushes) {
+        Waypoint next = out.back();
+        next.player = layout.applyPush(next.boxes.data(), p);
+        out.push_back(std::move(next));
+    }
+    return out;
+}
+
+Cost segmentCost(const Layout &layout, const Waypoint &from,
+                 const Push *begin, const Push *end) {
+    Cost cost;
+    Waypoint at = from;
+    std::vector<uint32_t> dist;
+    for (const Push *p = begin; p != end; ++p) {
+        walkDistances(layout, at.player, at.boxes.data(), dist);
+        cost.moves += dist[layout.neighbor(p->box, opposite(p->dir))] + 1;
+        cost.pushes++;
+        at.player = layout.applyPush(at.boxes.data(), *p);
+    }
+    return cost;
+}
+
+// Cheapest pushes from `from` to `to` (to.player == None: any player)
+// that beat bound without more pushes. Dijkstra on moves, then pushes.
+bool searchWindow(const Layout &layout, const Waypoint &from,
+                  const Waypoint &to, const Cost &bound,
+                  Clock::time_point deadline, std::vector<Push> &out) {
+    struct Node {
+        uint32_t parent;
+        uint32_t player;
+        Push push;
+        Cost cost;
+    };
+    struct Entry {
+        Cost cost;
+        uint32_t node;
+        bool operator>(const Entry &other) const {
+            return other.cost < cost;
+        }
+    };
+    const size_t boxBytes = layout.boxBytes();
+    std::vector<Node> nodes;
+    std::vector<uint8_t> boxes; // boxBytes per node
+    std::unordered_map<std::string, Cost> best;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    auto key = [&](uint32_t player, const uint8_t *b) {
+        std::string k(reinterpret_cast<const char *>(b), boxBytes);
+        k.append(reinterpret_cast<const char *>(&player), sizeof(player));
+        return k;
+    };
+    nodes.push_back({NodeStore::NoParent, from.player, {}, Cost()});
+    boxes.assign(from.boxes.begin(), from.boxes.end());
+    best.emplace(key(from.player, from.boxes.data()), Cost());
+    open.push({Cost(), 0});
+
+    std::vector<uint32_t> dist;
+    std::vector<Push> pushes;
+    std::vector<uint8_t> next(boxBytes);
+    for (size_t expansions = 0; !open.empty(); ++expansions) {
+        if (expansions % CheckInterval == 0 && Clock::now() >= deadline)
+            return false;
+        const Entry e = open.top();
+        open.pop();
+        const Node node = nodes[e.node];
+        const uint8_t *at = boxes.data() + e.node * boxBytes;
+        if (best[key(node.player, at)] < node.cost)
+            continue;
+
+        if (std::memcmp(at, to.boxes.data(), boxBytes) == 0 &&
+            (to.player == Layout::None || to.player == node.player)) {
+            if (!(node.cost < bound))
+                return false;
+            out.clear();
+            for (uint32_t n = e.node; nodes[n].parent != NodeStore::NoParent;
+                 n = nodes[n].parent) {
+                out.push_back(nodes[n].push);
+            }
+            std::reverse(out.begin(), out.end());
+            return true;
+        }
+
+        walkDistances(layout, node.player, at, dist);
+        layout.pushes(node.player, at, pushes);
+        for (const Push &p : pushes) {
+            Cost cost = node.cost;
+            cost.moves += dist[layout.neighbor(p.box, opposite(p.dir))] + 1;
+            cost.pushes++;
+            if (cost.moves > bound.moves || cost.pushes > bound.pushes)
+                continue;
+            std::memcpy(next.data(), boxes.data() + e.node * boxBytes,
+                        boxBytes);
+            const uint32_t player = layout.applyPush(next.data(), p);
+            auto [it, added] = best.emplace(key(player, next.data()), cost);
+            if (!added) {
+                if (!(cost < it->second))
+                    continue;
+                it->second = cost;
+            }
+            if (nodes.size() >= MaxWindowNodes)
+                return false;
+            const uint32_t child = static_cast<uint32_t>(nodes.size());
+            nodes.push_back({e.node, player, p, cost});
+            boxes.insert(boxes.end(), next.begin(), next.end());
+            open.push({cost, child});
+        }
+    }
+    return false;
+}
+} // namespace
+
+bool lurdToPushes(const Layout &layout, uint32_t player,
+                  std::vector<uint8_t> boxes, const std::string &lurd,
+                  std::vector<Push> &pushes) {
+    pushes.clear();
+    for (char c : lurd) {
+        const char *dirs = "udlr";
+        const char *d = std::strchr(
+            dirs, std::tolower(static_cast<unsigned char>(c)));
+        if (!d || !*d)
+            return false;
+        const Direction dir = static_cast<Direction>(d - dirs);
+        const uint32_t next = layout.neighbor(player, dir);
+        if (next == Layout::None)
+            return false;
+        if (Layout::hasBox(boxes.data(), next)) {
+            const uint32_t target = layout.neighbor(next, dir);
+            if (target == Layout::None ||
+                Layout::hasBox(boxes.data(), target))
+                return false;
+            pushes.push_back({next, dir});
+            layout.applyPush(boxes.data(), pushes.back());
+        }
+        player = next;
+    }
+    return true;
+}
+
+OptimizeResult optimizeSolution(const Board &level, const std::string &lurd,
+                                const OptimizerConfig &config) {
+    const Clock::time_point deadline = Clock::now() + config.time;
+    OptimizeResult result;
+    result.solution = lurd;
+    result.before = verifySolution(level, lurd);
+    result.after = result.before;
+    if (!result.before.solved)
+        return result;
+    result.valid = true;
+
+    const Layout layout(level);
+    Waypoint start{0, std::vector<uint8_t>(layout.boxBytes())};
+    std::vector<Push> pushes;
+    if (!layout.encode(level, start.player, start.boxes.data()) ||
+        !lurdToPushes(layout, start.player, start.boxes, lurd, pushes))
+        return result;
+
+    // Walks between pushes are made shortest by pushesToLurd at the end;
+    // windows only have to find better push sequences
+    const size_t window = std::max<size_t>(config.window, 2);
+    const size_t threads = std::max<size_t>(config.threads, 1);
+    size_t stale = 0;
+    const size_t staleLimit = pushes.size() > window ? 2 : 1;
+    while (stale < staleLimit && Clock::now() < deadline) {
+        const std::vector<Waypoint> points =
+            waypoints(layout, start, pushes);
+        const size_t n = pushes.size();
+        std::vector<std::pair<size_t, size_t>> windows;
+        size_t a = result.rounds % 2 ? window / 2 : 0;
+        if (a > 0)
+            windows.push_back({0, std::min(a, n)});
+        for (; a < n; a += window) {
+            windows.push_back({a, std::min(a + window, n)});
+        }
+        result.rounds++;
+
+        std::vector<std::vector<Push>> better(windows.size());
+        std::vector<uint8_t> found(windows.size(), 0);
+        std::atomic<size_t> nextWindow(0);
+        auto worker = [&] {
+            for (size_t i = nextWindow++; i < windows.size();
+                 i = nextWindow++) {
+                const auto [first, last] = windows[i];
+                if (last - first < 2)
+                    continue;
+                Waypoint to = points[last];
+                if (last == n)
+                    to.player = Layout::None;
+                const Cost bound =
+                    segmentCost(layout, points[first], pushes.data() + first,
+                                pushes.data() + last);
+                found[i] = searchWindow(layout, points[first], to, bound,
+                                        deadline, better[i]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < std::min(threads, windows.size()); ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &t : pool) {
+            t.join();
+        }
+
+        std::vector<Push> merged;
+        size_t improved = 0;
+        for (size_t i = 0; i < windows.size(); ++i) {
+            if (found[i]) {
+                merged.insert(merged.end(), better[i].begin(),
+                              better[i].end());
+                improved++;
+            } else {
+                merged.insert(merged.end(), pushes.begin() + windows[i].first,
+                              pushes.begin() + windows[i].second);
+            }
+        }
+        pushes.swap(merged);
+        result.improved += improved;
+        stale = improved ? 0 : stale + 1;
+    }
+
+    // Keep the input unless the result replays and is no worse in either
+    std::string optimized;
+    if (!pushesToLurd(layout, start.player, start.boxes, pushes, optimized))
+        return result;
+    const SolutionCheck after = verifySolution(level, optimized);
+    if (after.solved && after.moves <= result.before.moves &&
+        after.pushes <= result.before.pushes) {
+        result.solution = optimized;
+        result.after = after;
+    }
+    return result;
+}
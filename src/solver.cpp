@@ -0,0 +1,386 @@
+#include "solver.hpp"
+#include "level_analysis.hpp"
+#include "level_hash.hpp"
+#include "solution.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <time.h>
+
+namespace {
+// How often (in expansions) the clock is read
+const size_t CheckInterval = 256;
+
+// Budgets count the CPU time of the solving thread, so a pool with more
+// threads than cores slows levels down without timing them out
+double threadSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Open-addressing set of node indices keyed by (player, boxes). Each slot
+// keeps a few hash bits next to the index so most misses never touch the
+// node itself.
+class StateTable {
+public:
+    static constexpr uint32_t Empty = UINT32_MAX;
+
+    StateTable(const NodeStore &store, size_t boxBytes)
+        : store_(store), boxBytes_(boxBytes), slots_(1024, Slot{Empty, 0}),
+          size_(0) {}
+
+    // Slot holding this state, or the empty slot it would go into
+    size_t find(uint32_t player, const uint8_t *boxes, uint32_t &node) const {
+        const uint64_t h = hash(player, boxes);
+        const uint32_t tag = static_cast<uint32_t>(h >> 32);
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            const Slot &s = slots_[i];
+            if (s.node == Empty) {
+                node = Empty;
+                return i;
+            }
+            if (s.tag == tag && store_.player(s.node) == player &&
+                std::memcmp(store_.boxes(s.node), boxes, boxBytes_) == 0) {
+                node = s.node;
+                return i;
+            }
+        }
+    }
+
+    void set(size_t slot, uint32_t node) {
+        if (slots_[slot].node == Empty)
+            size_++;
+        slots_[slot] = {node, static_cast<uint32_t>(
+                                  hash(store_.player(node),
+                                       store_.boxes(node)) >> 32)};
+    }
+
+    // Keeps the load factor under 1/2; invalidates slot numbers
+    void reserve() {
+        if (size_ * 2 < slots_.size())
+            return;
+        std::vector<Slot> old(slots_.size() * 2, Slot{Empty, 0});
+        old.swap(slots_);
+        const size_t mask = slots_.size() - 1;
+        for (const Slot &s : old) {
+            if (s.node == Empty)
+                continue;
+            size_t i = hash(store_.player(s.node), store_.boxes(s.node)) &
+                       mask;
+            while (slots_[i].node != Empty)
+                i = (i + 1) & mask;
+            slots_[i] = s;
+        }
+    }
+
+    size_t bytes() const { return slots_.size() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint32_t node;
+        uint32_t tag;
+    };
+
+    uint64_t hash(uint32_t player, const uint8_t *boxes) const {
+        return hashBytes(boxes, boxBytes_, player).lo;
+    }
+
+    const NodeStore &store_;
+    size_t boxBytes_;
+    std::vector<Slot> slots_;
+    size_t size_;
+};
+
+bool blocked(const uint8_t *boxes, uint32_t cell) {
+    return cell == Layout::None || Layout::hasBox(boxes, cell);
+}
+
+// A box that was just pushed onto `cell` completes a 2x2 square of boxes
+// and walls with some box off its goal: none of those boxes can ever move
+bool squareDeadlock(const Layout &layout, const uint8_t *boxes,
+                    uint32_t cell) {
+    const Direction vertical[2] = {Direction::UP, Direction::DOWN};
+    const Direction horizontal[2] = {Direction::LEFT, Direction::RIGHT};
+    for (Direction v : vertical) {
+        for (Direction h : horizontal) {
+            const uint32_t a = layout.neighbor(cell, v);
+            const uint32_t b = layout.neighbor(cell, h);
+            uint32_t c = Layout::None;
+            if (a != Layout::None)
+                c = layout.neighbor(a, h);
+            else if (b != Layout::None)
+                c = layout.neighbor(b, v);
+            if (!blocked(boxes, a) || !blocked(boxes, b) ||
+                !blocked(boxes, c))
+                continue;
+            bool offGoal = !layout.isGoal(cell);
+            for (uint32_t other : {a, b, c}) {
+                offGoal |= other != Layout::None && !layout.isGoal(other);
+            }
+            if (offGoal)
+                return true;
+        }
+    }
+    return false;
+}
+
+// Recovers the pushes along a node's parent chain from the box sets;
+// with macros each step is the macro its first push starts
+std::vector<Push> pushPath(const Layout &layout, const NodeStore &store,
+                           const LevelAnalysis *analysis, uint32_t node) {
+    std::vector<Push> path;
+    std::vector<Push> follow;
+    std::vector<uint8_t> boxes;
+    const size_t bytes = layout.boxBytes();
+    for (uint32_t parent = store.parent(node); parent != NodeStore::NoParent;
+         node = parent, parent = store.parent(node)) {
+        const uint8_t *before = store.boxes(parent);
+        const uint8_t *after = store.boxes(node);
+        for (size_t i = 0; i < bytes; ++i) {
+            const uint8_t gone = before[i] & ~after[i];
+            if (gone) {
+                const uint32_t box = static_cast<uint32_t>(
+                    i * 8 + __builtin_ctz(gone));
+                const Push first{box, static_cast<Direction>(store.move(node))};
+                follow.clear();
+                if (analysis) {
+                    boxes.assign(before, before + bytes);
+                    layout.applyPush(boxes.data(), first);
+                    analysis->extend(boxes.data(), first, follow);
+                }
+                // Added backwards, like the whole path
+                path.insert(path.end(), follow.rbegin(), follow.rend());
+                path.push_back(first);
+                break;
+            }
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+} // namespace
+
+const char *toString(SolveStatus status) {
+    switch (status) {
+    case SolveStatus::SOLVED:
+        return "solved";
+    case SolveStatus::UNSOLVABLE:
+        return "unsolvable";
+    case SolveStatus::TIME_OUT:
+        return "timeout";
+    case SolveStatus::OUT_OF_MEMORY:
+        return "memory";
+    case SolveStatus::INVALID:
+        return "invalid";
+    }
+    return "invalid";
+}
+
+PushDistances::PushDistances(const Layout &layout)
+    : nearest_(layout.cellCount(), Unreachable) {
+    // Pull boxes backwards from all goals at once, as for dead squares
+    std::vector<uint32_t> queue(layout.goals());
+    for (uint32_t goal : queue) {
+        nearest_[goal] = 0;
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t cell = queue[head];
+        for (size_t d = 0; d < 4; ++d) {
+            const Direction back = opposite(static_cast<Direction>(d));
+            const uint32_t from = layout.neighbor(cell, back);
+            if (from == Layout::None || nearest_[from] != Unreachable ||
+                layout.neighbor(from, back) == Layout::None)
+                continue;
+            nearest_[from] = nearest_[cell] + 1;
+            queue.push_back(from);
+        }
+    }
+}
+
+uint16_t PushDistances::toNearestGoal(uint32_t cell) const {
+    return nearest_[cell];
+}
+
+uint32_t PushDistances::lowerBound(const uint8_t *boxes) const {
+    uint32_t total = 0;
+    for (size_t i = 0; i < nearest_.size(); i += 8) {
+        for (uint8_t bits = boxes[i / 8]; bits; bits &= bits - 1) {
+            const uint16_t d = nearest_[i + __builtin_ctz(bits)];
+            if (d == Unreachable)
+                return Unreachable;
+            total += d;
+        }
+    }
+    return total;
+}
+
+SolverResult solve(const Board &level, const SolverLimits &limits,
+                   const SolverOptions &options) {
+    SolverResult result;
+    const double start = threadSeconds();
+    const double deadline =
+        start + std::chrono::duration<double>(limits.time).count();
+    auto finish = [&](SolveStatus status) {
+        result.status = status;
+        result.seconds = threadSeconds() - start;
+        return result;
+    };
+
+    Board check = level;
+    if (!check.normalize().valid())
+        return finish(SolveStatus::INVALID);
+
+    const Layout layout(level);
+    const size_t boxBytes = layout.boxBytes();
+    std::vector<uint8_t> boxes(boxBytes);
+    uint32_t startPlayer = 0;
+    if (!layout.encode(level, startPlayer, boxes.data()))
+        return finish(SolveStatus::INVALID);
+    const PushDistances distances(layout);
+    std::optional<LevelAnalysis> analysis;
+    if (options.macros)
+        analysis.emplace(layout, boxes.data());
+    const LevelAnalysis *macros = analysis ? &*analysis : nullptr;
+
+    NodeStore store(layout, 1 << 14);
+    StateTable table(store, boxBytes);
+    std::vector<uint32_t> cost;      // Pushes from the start, per node
+    std::vector<uint8_t> superseded; // A cheaper copy of the state exists
+    // Bucket queue on f = cost + lower bound; LIFO within a bucket
+    std::vector<std::vector<uint32_t>> open;
+    size_t openSize = 0;
+
+    auto push = [&](uint32_t node, uint32_t f) {
+        if (open.size() <= f)
+            open.resize(f + 1);
+        open[f].push_back(node);
+        openSize++;
+    };
+
+    const uint32_t h0 = distances.lowerBound(boxes.data());
+    if (h0 == PushDistances::Unreachable)
+        return finish(SolveStatus::UNSOLVABLE);
+    {
+        const uint32_t player = layout.normalizePlayer(startPlayer,
+                                                       boxes.data());
+        uint32_t found;
+        const size_t slot = table.find(player, boxes.data(), found);
+        const uint32_t root =
+            store.add(NodeStore::NoParent, player, 0, boxes.data());
+        table.set(slot, root);
+        cost.push_back(0);
+        superseded.push_back(0);
+        push(root, h0);
+    }
+
+    std::vector<Push> pushes;
+    std::vector<Push> follow;
+    std::vector<uint8_t> next(boxBytes);
+    size_t expansions = 0;
+    for (size_t f = h0; f < open.size(); ++f) {
+        while (!open[f].empty()) {
+            const uint32_t node = open[f].back();
+            open[f].pop_back();
+            openSize--;
+            if (superseded[node])
+                continue;
+
+            const uint8_t *current = store.boxes(node);
+            if (layout.isSolved(current)) {
+                result.nodes = store.size();
+                std::string lurd;
+                boxes.assign(boxBytes, 0);
+                layout.encode(level, startPlayer, boxes.data());
+                const std::vector<Push> path =
+                    pushPath(layout, store, macros, node);
+                if (!pushesToLurd(layout, startPlayer, boxes, path, lurd))
+                    return finish(SolveStatus::INVALID);
+                const SolutionCheck replay = verifySolution(level, lurd);
+                result.solution = lurd;
+                result.moves = replay.moves;
+                result.pushes = replay.pushes;
+                return finish(replay.solved ? SolveStatus::SOLVED
+                                            : SolveStatus::INVALID);
+            }
+
+            result.nodes = store.size();
+            const size_t bytes = store.bytesReserved() + table.bytes() +
+                                 cost.capacity() * sizeof(uint32_t) +
+                                 superseded.capacity() +
+                                 openSize * sizeof(uint32_t);
+            if (bytes > limits.memoryBytes)
+                return finish(SolveStatus::OUT_OF_MEMORY);
+            if (expansions++ % CheckInterval == 0 && threadSeconds() >= deadline)
+                return finish(SolveStatus::TIME_OUT);
+
+            layout.pushes(store.player(node), current, pushes);
+            for (const Push &p : pushes) {
+                // store may grow below, so copy before touching it
+                std::memcpy(next.data(), store.boxes(node), boxBytes);
+                uint32_t moved = layout.applyPush(next.data(), p);
+                follow.clear();
+                if (macros)
+                    moved = macros->extend(next.data(), p, follow);
+                const Push &last = follow.empty() ? p : follow.back();
+                if (squareDeadlock(layout, next.data(),
+                                   layout.neighbor(last.box, last.dir)))
+                    continue;
+                const uint32_t g =
+                    cost[node] + 1 + static_cast<uint32_t>(follow.size());
+                const uint32_t player =
+                    layout.normalizePlayer(moved, next.data());
+
+                table.reserve();
+                uint32_t found;
+                const size_t slot = table.find(player, next.data(), found);
+                if (found != StateTable::Empty && cost[found] <= g)
+                    continue;
+                const uint32_t h = distances.lowerBound(next.data());
+                if (h == PushDistances::Unreachable)
+                    continue;
+                if (found != StateTable::Empty)
+                    superseded[found] = 1;
+                const uint32_t child = store.add(
+                    node, player, static_cast<uint8_t>(p.dir), next.data());
+                table.set(slot, child);
+                cost.push_back(g);
+                superseded.push_back(0);
+                push(child, g + h);
+            }
+        }
+    }
+    result.nodes = store.size();
+    return finish(SolveStatus::UNSOLVABLE);
+}
+
+double estimateDifficulty(const Board &level) {
+    Board check = level;
+    if (!check.normalize().valid())
+        return std::numeric_limits<double>::infinity();
+    const Layout layout(level);
+    std::vector<uint8_t> boxes(layout.boxBytes());
+    uint32_t player = 0;
+    if (!layout.encode(level, player, boxes.data()))
+        return std::numeric_limits<double>::infinity();
+
+    size_t live = 0;
+    size_t boxCount = 0;
+    for (uint32_t cell = 0; cell < layout.cellCount(); ++cell) {
+        live += !layout.isDead(cell);
+        boxCount += Layout::hasBox(boxes.data(), cell);
+    }
+    // log2 of the ways to place the boxes on live cells, plus a little
+    // for the pushes the boxes need at least
+    double bits = 0;
+    for (size_t i = 0; i < boxCount && i < live; ++i) {
+        bits += std::log2(double(live - i) / double(i + 1));
+    }
+    const uint32_t bound = PushDistances(layout).lowerBound(boxes.data());
+    if (bound == PushDistances::Unreachable)
+        return bits;
+    return bits + 0.1 * bound;
+}
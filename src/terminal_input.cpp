@@ -0,0 +1,130 @@
+#include "terminal_input.hpp"
+#include <poll.h>
+#include <unistd.h>
+
+namespace {
+// How often the reader wakes up to notice stop() when no keys arrive
+const int PollTimeoutMs = 50;
+} // namespace
+
+TerminalInput::TerminalInput(InputQueue &queue, int fd)
+    : queue_(queue), fd_(fd), rawMode_(false), saved_(), running_(false) {}
+
+TerminalInput::~TerminalInput() { stop(); }
+
+bool TerminalInput::start() {
+    if (running_)
+        return false;
+
+    // Raw mode is optional: pipes and files are read as they are
+    if (isatty(fd_) && tcgetattr(fd_, &saved_) == 0) {
+        struct termios raw = saved_;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        rawMode_ = tcsetattr(fd_, TCSANOW, &raw) == 0;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&TerminalInput::readLoop, this);
+    return true;
+}
+
+void TerminalInput::stop() {
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+    if (rawMode_) {
+        tcsetattr(fd_, TCSANOW, &saved_);
+        rawMode_ = false;
+    }
+}
+
+void TerminalInput::emit(Command command) {
+    const InputEvent event{command, std::chrono::steady_clock::now()};
+    // A full queue only stalls this thread, never the game loop
+    while (!queue_.push(event)) {
+        if (!running_)
+            return;
+        std::this_thread::yield();
+    }
+}
+
+void TerminalInput::readLoop() {
+    // Arrow keys arrive as ESC [ A..D
+    int escape = 0;
+    char buf[64];
+
+    while (running_) {
+        struct pollfd pfd = {fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, PollTimeoutMs);
+        if (ready <= 0)
+            continue;
+        ssize_t n = read(fd_, buf, sizeof(buf));
+        if (n <= 0) {
+            // End of input behaves like a quit request
+            emit(Command::QUIT);
+            return;
+        }
+
+        for (ssize_t i = 0; i < n; ++i) {
+            char c = buf[i];
+            if (escape == 1) {
+                escape = 0;
+                if (c == '[') {
+                    escape = 2;
+                    continue;
+                }
+                // A bare ESC: handle c as an ordinary key below
+            }
+            if (escape == 2) {
+                escape = 0;
+                switch (c) {
+                case 'A':
+                    emit(Command::UP);
+                    break;
+                case 'B':
+                    emit(Command::DOWN);
+                    break;
+                case 'C':
+                    emit(Command::RIGHT);
+                    break;
+                case 'D':
+                    emit(Command::LEFT);
+                    break;
+                }
+                continue;
+            }
+
+            switch (c) {
+            case '\033':
+                escape = 1;
+                break;
+            case 'w':
+            case 'W':
+                emit(Command::UP);
+                break;
+            case 's':
+            case 'S':
+                emit(Command::DOWN);
+                break;
+            case 'a':
+            case 'A':
+                emit(Command::LEFT);
+                break;
+            case 'd':
+            case 'D':
+                emit(Command::RIGHT);
+                break;
+            case 'p':
+            case 'P':
+                emit(Command::PAUSE);
+                break;
+            case 'q':
+            case 'Q':
+                emit(Command::QUIT);
+                break;
+            }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "board.hpp"
+#include "test_boards.hpp"
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
@@ -117,6 +118,33 @@ TEST_F(BoardTest, SaveAndLoad) {
     std::filesystem::remove(tempFile);
 }
 
+// Test that a damaged header is refused before the board is sized
+TEST_F(BoardTest, LoadRejectsBadHeader) {
+    const std::string file = "board_test_bad_header.bin";
+    auto writeHeader = [&](uint32_t w, uint32_t h, size_t cells) {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&w), sizeof(w));
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        const uint32_t cell = 0;
+        for (size_t i = 0; i < cells; ++i) {
+            out.write(reinterpret_cast<const char *>(&cell), sizeof(cell));
+        }
+    };
+
+    Board loaded;
+    writeHeader(0xFFFFFFFF, 0xFFFFFFFF, 0);
+    EXPECT_FALSE(loaded.loadFromFile(file));
+    writeHeader(Board::MaxSide, Board::MaxSide, 4); // Truncated
+    EXPECT_FALSE(loaded.loadFromFile(file));
+    writeHeader(3, 3, 8);
+    EXPECT_FALSE(loaded.loadFromFile(file));
+    writeHeader(3, 3, 9);
+    EXPECT_TRUE(loaded.loadFromFile(file));
+    EXPECT_EQ(loaded.width(), 3u);
+
+    std::filesystem::remove(file);
+}
+
 // Test print functionality by capturing stdout
 TEST_F(BoardTest, Print) {
     // Create a test board with recognizable pattern
@@ -148,3 +176,61 @@ TEST_F(BoardTest, Print) {
     std::string expected = "X.O\ng@s\n   \n";
     EXPECT_EQ(output, expected);
 }
+
+// Test that normalize trims exterior cells and crops to the walls
+TEST_F(BoardTest, NormalizeCrops) {
+    fillBoard(*board, {"           ",
+                       "  XXXXX  . ",
+                       "  X@O.X    ",
+                       " .X.XgXXX  ",
+                       "  X.....X  ",
+                       "  XXXXXXX  ",
+                       "           "});
+
+    LevelCheck check = board->normalize();
+    EXPECT_TRUE(check.valid());
+    EXPECT_TRUE(check.enclosed);
+    EXPECT_EQ(check.players, 1u);
+    EXPECT_EQ(check.boxes, 1u);
+    EXPECT_EQ(check.goals, 1u);
+    EXPECT_EQ(boardRows(*board), (std::vector<std::string>{"XXXXX  ",
+                                                           "X@O.X  ",
+                                                           "X.XgXXX",
+                                                           "X.....X",
+                                                           "XXXXXXX"}));
+}
+
+// Test the invariants normalize reports, leaving the board untouched
+TEST_F(BoardTest, NormalizeRejects) {
+    const std::vector<std::string> open = {"XXXXX",
+                                           "X@Og.",
+                                           "XXXXX"};
+    fillBoard(*board, open);
+    LevelCheck check = board->normalize();
+    EXPECT_FALSE(check.valid());
+    EXPECT_FALSE(check.enclosed);
+    EXPECT_EQ(boardRows(*board), open);
+
+    fillBoard(*board, {"XXXXX",
+                       "X@O@X",
+                       "XgXXX"});
+    check = board->normalize();
+    EXPECT_FALSE(check.valid());
+    EXPECT_EQ(check.players, 2u);
+
+    fillBoard(*board, {"XXXXXX",
+                       "X@OO.X",
+                       "X.g..X",
+                       "XXXXXX"});
+    check = board->normalize();
+    EXPECT_FALSE(check.valid());
+    EXPECT_EQ(check.problems.size(), 1u); // 2 boxes but 1 goal
+
+    fillBoard(*board, {"XXXXXXX",
+                       "X@Og.XX",
+                       "XXXXX.X",
+                       "XXXXXOX",
+                       "XXXXXXX"});
+    check = board->normalize();
+    EXPECT_FALSE(check.valid()); // A box walled off from the player
+}
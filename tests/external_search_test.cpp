@@ -0,0 +1,165 @@
+#include "external_search.hpp"
+#include "solution.hpp"
+#include "test_boards.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+const std::vector<std::string> TwoBoxes = {"XXXXXXXX",
+                                           "X..g...X",
+                                           "X.OXO..X",
+                                           "X@.g...X",
+                                           "XXXXXXXX"};
+} // namespace
+
+// Test fixture giving each test a scratch work directory
+class ExternalSearchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        workDir = "external_search_test_" + std::to_string(getpid());
+        std::filesystem::remove_all(workDir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(workDir); }
+
+    std::string workDir;
+};
+
+// Test that sorted records survive front coding
+TEST_F(ExternalSearchTest, RecordFiles) {
+    std::filesystem::create_directories(workDir);
+    const std::string file = workDir + "/records.dat";
+    std::vector<std::vector<uint8_t>> records = {
+        {0, 0, 0, 0, 1}, {0, 0, 0, 0, 2}, {0, 7, 0, 0, 0}, {9, 9, 9, 9, 9}};
+
+    RecordWriter writer;
+    ASSERT_TRUE(writer.open(file, 5));
+    for (const auto &r : records) {
+        writer.write(r.data());
+    }
+    EXPECT_EQ(writer.count(), 4u);
+    ASSERT_TRUE(writer.close());
+
+    RecordReader reader;
+    ASSERT_TRUE(reader.open(file, 5));
+    std::vector<uint8_t> r(5);
+    for (const auto &expected : records) {
+        ASSERT_TRUE(reader.next(r.data()));
+        EXPECT_EQ(r, expected);
+    }
+    EXPECT_FALSE(reader.next(r.data()));
+    EXPECT_FALSE(reader.bad());
+
+    // A file cut inside its last record is damaged, not just finished
+    std::filesystem::resize_file(file,
+                                 std::filesystem::file_size(file) - 1);
+    RecordReader cut;
+    ASSERT_TRUE(cut.open(file, 5));
+    size_t count = 0;
+    while (cut.next(r.data())) {
+        count++;
+    }
+    EXPECT_EQ(count, 3u);
+    EXPECT_TRUE(cut.bad());
+
+    // A different record size is refused
+    RecordReader wrong;
+    EXPECT_FALSE(wrong.open(file, 6));
+}
+
+// Test a push-optimal solve with a tiny memory cap forcing many runs
+TEST_F(ExternalSearchTest, SolvesWithSpills) {
+    Board level = makeBoard(TwoBoxes);
+    ExternalSearchConfig config;
+    config.workDir = workDir;
+    config.memoryBytes = 64;
+
+    ExternalSearchResult result = ExternalSearch(level, config).run();
+    ASSERT_TRUE(result.solved);
+    EXPECT_FALSE(result.resumed);
+    EXPECT_FALSE(result.ioError);
+    // Far more runs than the two merged at a time under this budget
+    EXPECT_GT(result.runs, 2 * result.depth);
+
+    SolutionCheck check = verifySolution(level, result.solution);
+    EXPECT_TRUE(check.solved);
+    EXPECT_EQ(check.pushes, result.depth);
+}
+
+// Test that an interrupted search resumes from its checkpoint
+TEST_F(ExternalSearchTest, Resumes) {
+    Board level = makeBoard(TwoBoxes);
+    ExternalSearchConfig config;
+    config.workDir = workDir;
+    config.maxDepth = 2;
+
+    ExternalSearchResult first = ExternalSearch(level, config).run();
+    EXPECT_FALSE(first.solved);
+    EXPECT_FALSE(first.exhausted);
+    EXPECT_EQ(first.depth, 2u);
+    EXPECT_TRUE(std::filesystem::exists(workDir + "/checkpoint"));
+
+    config.maxDepth = SIZE_MAX;
+    ExternalSearchResult second = ExternalSearch(level, config).run();
+    EXPECT_TRUE(second.resumed);
+    ASSERT_TRUE(second.solved);
+    EXPECT_TRUE(verifySolution(level, second.solution).solved);
+
+    // A checkpoint of another level is ignored
+    Board other = makeBoard({"XXXXXX", "X@O.gX", "XXXXXX"});
+    ExternalSearchResult third = ExternalSearch(other, config).run();
+    EXPECT_FALSE(third.resumed);
+    EXPECT_TRUE(third.solved);
+    EXPECT_EQ(third.solution, "RR");
+}
+
+// Test that an unusable work directory is an I/O error, not a budget stop
+TEST_F(ExternalSearchTest, IoError) {
+    std::filesystem::create_directories(workDir);
+    std::ofstream(workDir + "/file") << "not a directory";
+    ExternalSearchConfig config;
+    config.workDir = workDir + "/file/work";
+
+    ExternalSearchResult result =
+        ExternalSearch(makeBoard(TwoBoxes), config).run();
+    EXPECT_TRUE(result.ioError);
+    EXPECT_FALSE(result.solved);
+    EXPECT_FALSE(result.exhausted);
+}
+
+// Test that a layer cut short by a crash is an I/O error on resume, not a
+// search that ran out of states
+TEST_F(ExternalSearchTest, TruncatedLayer) {
+    Board level = makeBoard(TwoBoxes);
+    ExternalSearchConfig config;
+    config.workDir = workDir;
+    config.maxDepth = 2;
+    ASSERT_FALSE(ExternalSearch(level, config).run().solved);
+
+    const std::string layer = workDir + "/layer-2.dat";
+    const auto size = std::filesystem::file_size(layer);
+    ASSERT_GT(size, 9u);
+    std::filesystem::resize_file(layer, size - 1);
+
+    config.maxDepth = SIZE_MAX;
+    ExternalSearchResult result = ExternalSearch(level, config).run();
+    EXPECT_TRUE(result.resumed);
+    EXPECT_TRUE(result.ioError);
+    EXPECT_FALSE(result.solved);
+    EXPECT_FALSE(result.exhausted);
+}
+
+// Test that a dead end is reported as exhausted
+TEST_F(ExternalSearchTest, Exhausted) {
+    Board level = makeBoard({"XXXXXXX", "X@OOggX", "XXXXXXX"});
+    ExternalSearchConfig config;
+    config.workDir = workDir;
+
+    ExternalSearchResult result = ExternalSearch(level, config).run();
+    EXPECT_FALSE(result.solved);
+    EXPECT_TRUE(result.exhausted);
+}
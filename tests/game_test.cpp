@@ -1,4 +1,6 @@
 #include "game.hpp"
+#include "test_boards.hpp"
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <iostream>
 
@@ -22,6 +24,24 @@ TEST_F(GameTest, Initialize) {
     EXPECT_FALSE(game->isLevelComplete());
 }
 
+// Test that a game reports the board it plays on, for views to draw
+TEST_F(GameTest, OwnBoard) {
+    Board own;
+    Game local(own);
+    EXPECT_EQ(&local.board(), &own);
+    EXPECT_EQ(&game->board(), &Board::instance());
+}
+
+// Test a game without an input queue, as the server runs one per session
+TEST_F(GameTest, WithoutInput) {
+    Board own;
+    Game local(own, Game::Input::None);
+    local.initialize();
+    local.processInput(); // Nothing to drain
+    EXPECT_TRUE(local.movePlayer(Direction::RIGHT));
+    EXPECT_EQ(local.inputLatency().count, 0u);
+}
+
 // Test player movement
 TEST_F(GameTest, PlayerMovement) {
     // Test moving in all four directions
@@ -73,3 +93,72 @@ TEST_F(GameTest, ManualLevelCompletion) {
     // Verify level completion
     EXPECT_TRUE(game->isLevelComplete());
 }
+
+// Test that moves report exactly the cells they changed
+TEST_F(GameTest, DirtyCells) {
+    using Cell = std::pair<size_t, size_t>;
+    game->clearDirtyCells();
+
+    // Plain step: new and old player cell
+    EXPECT_TRUE(game->movePlayer(Direction::RIGHT));
+    EXPECT_EQ(game->dirtyCells(), (std::vector<Cell>{{2, 1}, {1, 1}}));
+    game->clearDirtyCells();
+
+    // Push: box destination, box origin (new player cell), old player cell
+    EXPECT_TRUE(game->movePlayer(Direction::DOWN));
+    EXPECT_EQ(game->dirtyCells(),
+              (std::vector<Cell>{{2, 3}, {2, 2}, {2, 1}}));
+    game->clearDirtyCells();
+
+    // Blocked move leaves nothing to redraw
+    EXPECT_TRUE(game->movePlayer(Direction::LEFT));
+    game->clearDirtyCells();
+    EXPECT_FALSE(game->movePlayer(Direction::LEFT));
+    EXPECT_TRUE(game->dirtyCells().empty());
+}
+
+// Test that queued input is applied in order in a single batch
+TEST_F(GameTest, ProcessInputDrainsQueue) {
+    const size_t before = game->inputLatency().count;
+    const auto now = std::chrono::steady_clock::now();
+    for (Command c : {Command::RIGHT, Command::DOWN, Command::RIGHT}) {
+        EXPECT_TRUE(game->inputQueue().push({c, now}));
+    }
+    game->clearDirtyCells();
+
+    game->processInput();
+
+    // RIGHT, DOWN pushes the box from (2,2) to (2,3), RIGHT steps to (3,2)
+    EXPECT_TRUE(game->inputQueue().empty());
+    EXPECT_EQ(Board::instance()[2][3] & Type::At, Type::At);
+    EXPECT_EQ(Board::instance()[3][2] & Type::Box, Type::Box);
+    EXPECT_EQ(game->dirtyCells().size(), 7u);
+    EXPECT_EQ(game->inputLatency().count, before + 3);
+}
+
+// Test that loadLevel validates and normalizes the level file
+TEST_F(GameTest, LoadLevelNormalizes) {
+    const std::string file = "game_test_level.bin";
+    Board level = makeBoard({"         ",
+                             " XXXXXX  ",
+                             " X@O.gX  ",
+                             " XXXXXX  "});
+    ASSERT_TRUE(level.saveToFile(file));
+    EXPECT_TRUE(game->loadLevel(file));
+    EXPECT_EQ(Board::instance().width(), 6u);
+    EXPECT_EQ(Board::instance().height(), 3u);
+    EXPECT_TRUE(game->movePlayer(Direction::RIGHT));
+    EXPECT_TRUE(game->movePlayer(Direction::RIGHT));
+    EXPECT_TRUE(game->isLevelComplete());
+
+    // Missing goal
+    level[2][5] = Type::Floor;
+    ASSERT_TRUE(level.saveToFile(file));
+    EXPECT_FALSE(game->loadLevel(file));
+    // The rejected level must not replace the one being played
+    EXPECT_EQ(Board::instance().width(), 6u);
+    EXPECT_EQ(Board::instance()[1][4] & Type::Box, Type::Box);
+    EXPECT_TRUE(game->isLevelComplete());
+
+    std::filesystem::remove(file);
+}
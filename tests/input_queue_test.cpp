@@ -0,0 +1,118 @@
+#include "input_queue.hpp"
+#include "terminal_input.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Test basic FIFO behaviour and the full/empty edges
+TEST(InputQueueTest, PushPopFullEmpty) {
+    SpscQueue<int, 4> queue;
+    int value = 0;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(value));
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(4)); // Full
+    EXPECT_EQ(queue.size(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
+
+// Test that drain hands over the whole backlog in order
+TEST(InputQueueTest, DrainBatch) {
+    SpscQueue<int, 8> queue;
+    for (int i = 0; i < 6; ++i) {
+        queue.push(i);
+    }
+
+    std::vector<int> seen;
+    EXPECT_EQ(queue.drain([&seen](int v) { seen.push_back(v); }), 6u);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.drain([](int) {}), 0u);
+
+    // Indices keep running past the wrap-around point
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(queue.push(100 + i));
+    }
+    seen.clear();
+    queue.drain([&seen](int v) { seen.push_back(v); });
+    EXPECT_EQ(seen.size(), 8u);
+    EXPECT_EQ(seen.front(), 100);
+    EXPECT_EQ(seen.back(), 107);
+}
+
+// Test a producer thread bursting into a small queue: nothing is lost or
+// reordered as long as the producer retries on full
+TEST(InputQueueTest, ConcurrentBurst) {
+    SpscQueue<uint32_t, 16> queue;
+    const uint32_t total = 200000;
+
+    std::thread producer([&queue, total] {
+        for (uint32_t i = 0; i < total; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool inOrder = true;
+    while (expected < total) {
+        const size_t n = queue.drain([&](uint32_t v) {
+            inOrder = inOrder && (v == expected);
+            ++expected;
+        });
+        if (n == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(expected, total);
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test that the terminal reader decodes arrows and keeps the key after a
+// bare ESC
+TEST(InputQueueTest, TerminalKeys) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const char keys[] = "\033[Cd\033q";
+    ASSERT_EQ(write(fds[1], keys, sizeof(keys) - 1),
+              static_cast<ssize_t>(sizeof(keys) - 1));
+    close(fds[1]);
+
+    InputQueue queue;
+    TerminalInput input(queue, fds[0]);
+    ASSERT_TRUE(input.start());
+    // Arrow, letter, ESC then q, then the quit that ends the input
+    std::vector<Command> commands;
+    InputEvent event;
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (commands.size() < 4 &&
+           std::chrono::steady_clock::now() < deadline) {
+        if (queue.pop(event))
+            commands.push_back(event.command);
+        else
+            std::this_thread::yield();
+    }
+    input.stop();
+    close(fds[0]);
+
+    ASSERT_EQ(commands.size(), 4u);
+    EXPECT_EQ(commands[0], Command::RIGHT);
+    EXPECT_EQ(commands[1], Command::RIGHT);
+    EXPECT_EQ(commands[2], Command::QUIT);
+    EXPECT_EQ(commands[3], Command::QUIT);
+}
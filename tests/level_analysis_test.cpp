@@ -0,0 +1,146 @@
+#include "level_analysis.hpp"
+#include "solution.hpp"
+#include "solver.hpp"
+#include "test_boards.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+// Two rooms joined by a corridor, with a box and goal on each side
+const std::vector<std::string> Corridor = {"XXXXXXXXXXX",
+                                           "X...XXX...X",
+                                           "X.O.....g.X",
+                                           "X@..XXX.O.X",
+                                           "X.g.XXX...X",
+                                           "XXXXXXXXXXX"};
+// A dead end holding both goals, filled from its mouth at (4, 2)
+const std::vector<std::string> Pocket = {"XXXXXXXXXX",
+                                         "X....XXXXX",
+                                         "X.O....ggX",
+                                         "X@.O.XXXXX",
+                                         "X....XXXXX",
+                                         "XXXXXXXXXX"};
+// Three goals behind a corridor, big enough for the search to wander
+const std::vector<std::string> Store = {"XXXXXXXXXXXX",
+                                        "X....XXX...X",
+                                        "X.O.O......X",
+                                        "X@.O.XXXgg.X",
+                                        "X....XXX.g.X",
+                                        "XXXXXXXXXXXX"};
+
+struct Analyzed {
+    explicit Analyzed(const std::vector<std::string> &rows)
+        : level(makeBoard(rows)), layout(level),
+          boxes(layout.boxBytes()) {
+        layout.encode(level, player, boxes.data());
+    }
+
+    Board level;
+    Layout layout;
+    std::vector<uint8_t> boxes;
+    uint32_t player = 0;
+};
+} // namespace
+
+// Test tunnel and articulation cells
+TEST(LevelAnalysisTest, Structure) {
+    Analyzed a(Corridor);
+    LevelAnalysis analysis(a.layout, a.boxes.data());
+    for (size_t x = 4; x <= 6; ++x) {
+        const uint32_t cell = a.layout.cellAt(x, 2);
+        EXPECT_TRUE(analysis.isTunnel(cell, Direction::RIGHT));
+        EXPECT_FALSE(analysis.isTunnel(cell, Direction::UP));
+        EXPECT_TRUE(analysis.isArticulation(cell));
+    }
+    EXPECT_EQ(analysis.tunnelCount(), 3u);
+    // The corridor and both of its mouths
+    EXPECT_EQ(analysis.articulationCount(), 5u);
+    EXPECT_FALSE(analysis.isArticulation(a.layout.cellAt(2, 2)));
+    // Both sides hold a box, so neither is a goal room
+    EXPECT_TRUE(analysis.goalRooms().empty());
+}
+
+// Test that a box pushed along a tunnel with the player in it goes through
+TEST(LevelAnalysisTest, TunnelMacro) {
+    Analyzed a(Corridor);
+    LevelAnalysis analysis(a.layout, a.boxes.data());
+    std::vector<Push> follow;
+
+    // Pushed into the mouth from the open room: the player is not in the
+    // tunnel yet, so nothing follows
+    Push push{a.layout.cellAt(3, 2), Direction::RIGHT};
+    Layout::clearBox(a.boxes.data(), a.layout.cellAt(2, 2));
+    Layout::setBox(a.boxes.data(), push.box);
+    a.layout.applyPush(a.boxes.data(), push);
+    EXPECT_EQ(analysis.extend(a.boxes.data(), push, follow), push.box);
+    EXPECT_TRUE(follow.empty());
+
+    // One more push and the box runs out of the far end
+    push = {a.layout.cellAt(4, 2), Direction::RIGHT};
+    a.layout.applyPush(a.boxes.data(), push);
+    EXPECT_EQ(analysis.extend(a.boxes.data(), push, follow),
+              a.layout.cellAt(6, 2));
+    ASSERT_EQ(follow.size(), 2u);
+    EXPECT_EQ(follow[1].box, a.layout.cellAt(6, 2));
+    EXPECT_TRUE(Layout::hasBox(a.boxes.data(), a.layout.cellAt(7, 2)));
+}
+
+// Test the goal room fill order and its macro
+TEST(LevelAnalysisTest, GoalRoom) {
+    Analyzed a(Pocket);
+    LevelAnalysis analysis(a.layout, a.boxes.data());
+    ASSERT_EQ(analysis.goalRooms().size(), 1u);
+    const GoalRoom &room = analysis.goalRooms()[0];
+    EXPECT_EQ(room.entrance, a.layout.cellAt(4, 2));
+    EXPECT_EQ(room.cells.size(), 4u);
+    ASSERT_EQ(room.fillOrder.size(), 2u);
+    EXPECT_EQ(room.fillOrder[0], a.layout.cellAt(8, 2));
+    EXPECT_EQ(room.fillOrder[1], a.layout.cellAt(7, 2));
+
+    // Onto the entrance from the left: straight to the far goal
+    std::vector<Push> follow;
+    Layout::clearBox(a.boxes.data(), a.layout.cellAt(2, 2));
+    Layout::setBox(a.boxes.data(), a.layout.cellAt(3, 2));
+    const Push push{a.layout.cellAt(3, 2), Direction::RIGHT};
+    a.layout.applyPush(a.boxes.data(), push);
+    EXPECT_EQ(analysis.extend(a.boxes.data(), push, follow),
+              a.layout.cellAt(7, 2));
+    EXPECT_EQ(follow.size(), 4u);
+    EXPECT_TRUE(Layout::hasBox(a.boxes.data(), a.layout.cellAt(8, 2)));
+    EXPECT_FALSE(Layout::hasBox(a.boxes.data(), a.layout.cellAt(4, 2)));
+}
+
+// Test moving one box around the others
+TEST(LevelAnalysisTest, PushBoxTo) {
+    Analyzed a(Pocket);
+    std::vector<uint8_t> allowed(a.layout.cellCount(), 1);
+    std::vector<Push> pushes;
+    ASSERT_TRUE(pushBoxTo(a.layout, a.player, a.boxes.data(),
+                          a.layout.cellAt(2, 2), a.layout.cellAt(7, 2),
+                          allowed, pushes));
+    EXPECT_EQ(pushes.size(), 5u);
+    EXPECT_FALSE(pushBoxTo(a.layout, a.player, a.boxes.data(),
+                           a.layout.cellAt(2, 2), a.layout.cellAt(1, 1),
+                           allowed, pushes));
+}
+
+// Test that macro searches solve with no more nodes, and fewer once the
+// plain search has room to wander
+TEST(LevelAnalysisTest, SolverMacros) {
+    SolverOptions macros;
+    macros.macros = true;
+    for (const auto *rows : {&Corridor, &Pocket, &Store}) {
+        Board level = makeBoard(*rows);
+        SolverResult plain = solve(level, SolverLimits());
+        SolverResult fast = solve(level, SolverLimits(), macros);
+        ASSERT_EQ(plain.status, SolveStatus::SOLVED);
+        ASSERT_EQ(fast.status, SolveStatus::SOLVED);
+        EXPECT_TRUE(verifySolution(level, fast.solution).solved);
+        EXPECT_LE(fast.nodes, plain.nodes);
+        EXPECT_GE(fast.pushes, plain.pushes);
+        if (rows == &Store) {
+            EXPECT_LT(fast.nodes, plain.nodes);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "level_hash.hpp"
+#include "test_boards.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+const std::vector<std::string> Level = {"XXXXXX ",
+                                        "X@.O.X ",
+                                        "X.XX.XX",
+                                        "X..g..X",
+                                        "XXXXXXX"};
+
+// Rotates rows a quarter turn clockwise
+std::vector<std::string> rotate(const std::vector<std::string> &rows) {
+    std::vector<std::string> out(rows[0].size(), std::string(rows.size(), ' '));
+    for (size_t y = 0; y < rows.size(); ++y) {
+        for (size_t x = 0; x < rows[y].size(); ++x) {
+            out[x][rows.size() - 1 - y] = rows[y][x];
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> mirror(std::vector<std::string> rows) {
+    for (std::string &row : rows) {
+        row.assign(row.rbegin(), row.rend());
+    }
+    return rows;
+}
+} // namespace
+
+// Test that all 8 orientations share one canonical form and hash
+TEST(LevelHashTest, SymmetryInvariant) {
+    const LevelHash base = levelHash(makeBoard(Level));
+    std::vector<std::string> rows = Level;
+    for (int turn = 0; turn < 4; ++turn) {
+        EXPECT_EQ(levelHash(makeBoard(rows)), base) << "turn " << turn;
+        EXPECT_EQ(levelHash(makeBoard(mirror(rows))), base)
+            << "mirrored turn " << turn;
+        EXPECT_EQ(canonicalForm(makeBoard(rows)),
+                  canonicalForm(makeBoard(Level)));
+        rows = rotate(rows);
+    }
+}
+
+// Test that padding and the player's idle spot do not matter, but the
+// puzzle itself does
+TEST(LevelHashTest, Identity) {
+    const LevelHash base = levelHash(makeBoard(Level));
+
+    std::vector<std::string> padded = {"         "};
+    for (const std::string &row : Level) {
+        padded.push_back(" " + row + " ");
+    }
+    padded.push_back("         ");
+    EXPECT_EQ(levelHash(makeBoard(padded)), base);
+
+    std::vector<std::string> moved = Level;
+    moved[1] = "X..O.X ";
+    moved[3] = "X.@g..X";
+    EXPECT_EQ(levelHash(makeBoard(moved)), base);
+
+    // The player can walk around the loop to the box's other side, so
+    // that is the same puzzle; a moved box is not
+    std::vector<std::string> around = Level;
+    around[1] = "X..O@X ";
+    EXPECT_EQ(levelHash(makeBoard(around)), base);
+
+    std::vector<std::string> box = Level;
+    box[1] = "X@O..X ";
+    EXPECT_NE(levelHash(makeBoard(box)), base);
+
+    std::vector<std::string> goal = Level;
+    goal[3] = "X...g.X";
+    EXPECT_NE(levelHash(makeBoard(goal)), base);
+
+    EXPECT_EQ(levelHash(makeBoard(Level)).hex().size(), 32u);
+}
+
+// Test the hash on known MurmurHash3 x64 128 values
+TEST(LevelHashTest, HashBytes) {
+    LevelHash empty = hashBytes(nullptr, 0);
+    EXPECT_EQ(empty.hi, 0u);
+    EXPECT_EQ(empty.lo, 0u);
+
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+    LevelHash h = hashBytes(reinterpret_cast<const uint8_t *>(text.data()),
+                            text.size());
+    EXPECT_EQ(h.hi, 0xe34bbc7bbc071b6cULL);
+    EXPECT_EQ(h.lo, 0x7a433ca9c49a9347ULL);
+}
+
+// Test batch deduplication across files and batches
+TEST(LevelHashTest, Deduper) {
+    std::vector<std::vector<std::string>> levels = {
+        Level, rotate(Level), mirror(Level), {"XXXXX", "X@OgX", "XXXXX"}};
+
+    std::vector<std::string> files;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        files.push_back("level_hash_test_" + std::to_string(i) + ".bin");
+        ASSERT_TRUE(makeBoard(levels[i]).saveToFile(files.back()));
+    }
+    files.push_back("level_hash_test_missing.bin");
+
+    LevelDeduper deduper(3);
+    std::vector<LevelHash> hashes;
+    EXPECT_EQ(deduper.addFiles(files, &hashes),
+              (std::vector<size_t>{0, 3}));
+    EXPECT_EQ(hashes[1], hashes[0]);
+    EXPECT_EQ(deduper.uniqueCount(), 2u);
+    EXPECT_EQ(deduper.duplicateCount(), 2u);
+    EXPECT_EQ(deduper.failedCount(), 1u);
+
+    // A later batch remembers earlier levels
+    EXPECT_TRUE(deduper.addFiles({files[2]}).empty());
+
+    for (const std::string &file : files) {
+        std::filesystem::remove(file);
+    }
+}
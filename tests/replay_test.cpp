@@ -0,0 +1,142 @@
+#include "replay.hpp"
+#include "test_boards.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+using std::chrono::milliseconds;
+
+// Solves the level Game::initialize builds: "dRurD"
+InputLog solvingLog() {
+    InputLog log;
+    log.entries = {{milliseconds(0), Command::DOWN},
+                   {milliseconds(50), Command::RIGHT},
+                   {milliseconds(120), Command::UP},
+                   {milliseconds(250), Command::RIGHT},
+                   {milliseconds(450), Command::DOWN}};
+    return log;
+}
+
+Board defaultLevel() {
+    Board board;
+    Game(board).initialize();
+    return board;
+}
+
+std::string scratchFile(const char *name) {
+    return std::string(name) + "_" + std::to_string(getpid());
+}
+} // namespace
+
+// Test that inputs are logged relative to the start of the recording
+TEST(ReplayTest, RecordsInputs) {
+    Board board = defaultLevel();
+    Game game(board);
+    game.updateStateFromBoard();
+    InputLog log;
+    game.recordInputs(&log);
+
+    game.inputQueue().push({Command::DOWN, log.start + milliseconds(5)});
+    game.inputQueue().push({Command::PAUSE, log.start + milliseconds(7)});
+    game.processInput();
+    game.recordInputs(nullptr);
+    game.inputQueue().push({Command::PAUSE, log.start + milliseconds(9)});
+    game.processInput();
+
+    ASSERT_EQ(log.entries.size(), 2u);
+    EXPECT_EQ(log.entries[0].at, milliseconds(5));
+    EXPECT_EQ(log.entries[0].command, Command::DOWN);
+    EXPECT_EQ(log.entries[1].command, Command::PAUSE);
+
+    const std::string file = scratchFile("replay_test_inputs");
+    ASSERT_TRUE(log.save(file));
+    InputLog loaded;
+    ASSERT_TRUE(loaded.load(file));
+    std::filesystem::remove(file);
+    ASSERT_EQ(loaded.entries.size(), 2u);
+    EXPECT_EQ(loaded.entries[0].at, milliseconds(5));
+    EXPECT_EQ(loaded.entries[1].command, Command::PAUSE);
+    EXPECT_FALSE(loaded.load("no_such_file"));
+}
+
+// Test that the virtual clock makes frames and latencies deterministic
+TEST(ReplayTest, VirtualClock) {
+    Board board = defaultLevel();
+    Game game(board);
+    game.updateStateFromBoard();
+    const InputLog log = solvingLog();
+    ReplayClock clock(game, log);
+    std::ostringstream out;
+    std::vector<FrameCost> costs;
+
+    const auto started = std::chrono::steady_clock::now();
+    game.run(clock, out, &costs);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, milliseconds(400));
+
+    // Frames at 0, 100, ..., 500 ms; the last input and QUIT land at 500
+    EXPECT_EQ(costs.size(), 6u);
+    EXPECT_EQ(clock.delivered(), 5u);
+    EXPECT_TRUE(game.isLevelComplete());
+    EXPECT_EQ(game.inputLatency().count, 6u);
+    EXPECT_EQ(game.inputLatency().max, milliseconds(80));
+    EXPECT_EQ(game.inputLatency().total, milliseconds(230));
+    EXPECT_NE(out.str().find("Sokoban - Playing"), std::string::npos);
+}
+
+// Test a full replay over several passes
+TEST(ReplayTest, ReplaySession) {
+    ReplayReport report = replaySession(defaultLevel(), solvingLog(), 3);
+    EXPECT_EQ(report.frames, 6u);
+    EXPECT_EQ(report.inputs, 5u);
+    EXPECT_TRUE(report.completed);
+    EXPECT_GT(report.render.max, 0);
+    EXPECT_LE(report.frame.p50, report.frame.p99);
+    EXPECT_LE(report.frame.p99, report.frame.max);
+
+    // Nothing recorded: one frame, then the clock quits
+    EXPECT_EQ(replaySession(defaultLevel(), InputLog()).frames, 1u);
+}
+
+// Test nearest-rank percentiles
+TEST(ReplayTest, Summarize) {
+    std::vector<std::chrono::nanoseconds> samples;
+    for (int i = 100; i >= 1; --i) {
+        samples.push_back(std::chrono::microseconds(i));
+    }
+    CostSummary s = summarize(samples);
+    EXPECT_DOUBLE_EQ(s.p50, 50);
+    EXPECT_DOUBLE_EQ(s.p99, 99);
+    EXPECT_DOUBLE_EQ(s.max, 100);
+    EXPECT_DOUBLE_EQ(summarize({}).p99, 0);
+}
+
+// Test baseline files and tolerance checks
+TEST(ReplayTest, Baseline) {
+    ReplayReport report;
+    report.update.p99 = 100;
+    report.render.p99 = 400;
+    report.frame.p99 = 480;
+    FrameBaseline baseline = FrameBaseline::fromReport(report);
+
+    const std::string file = scratchFile("replay_test_baseline");
+    ASSERT_TRUE(baseline.save(file));
+    FrameBaseline loaded;
+    ASSERT_TRUE(loaded.load(file));
+    std::filesystem::remove(file);
+    EXPECT_DOUBLE_EQ(loaded.render, 400);
+
+    Tolerance tolerance;
+    tolerance.ratio = 0.10;
+    tolerance.slackMicros = 5;
+    EXPECT_TRUE(checkBaseline(report, loaded, tolerance).empty());
+
+    report.render.p99 = 446; // Limit is 400 * 1.1 + 5 = 445
+    std::vector<std::string> problems =
+        checkBaseline(report, loaded, tolerance);
+    ASSERT_EQ(problems.size(), 1u);
+    EXPECT_EQ(problems[0].rfind("render", 0), 0u);
+}
@@ -0,0 +1,119 @@
+#include "arena.hpp"
+#include "search_node.hpp"
+#include "test_boards.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Test that arena allocations are aligned, disjoint and freed in bulk
+TEST(ArenaTest, AllocateAndReset) {
+    Arena arena(256);
+    auto *a = arena.allocateArray<uint64_t>(4);
+    auto *b = arena.allocateArray<uint8_t>(3);
+    auto *c = arena.allocateArray<uint32_t>(2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(uint64_t), 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % alignof(uint32_t), 0u);
+    EXPECT_GE(reinterpret_cast<uint8_t *>(b),
+              reinterpret_cast<uint8_t *>(a + 4));
+    EXPECT_GE(reinterpret_cast<uint8_t *>(c), b + 3);
+
+    // Fills the first block, then needs an oversized one
+    arena.allocate(150);
+    arena.allocate(1000);
+    EXPECT_GE(arena.bytesReserved(), 256u + 1000u);
+    EXPECT_GE(arena.bytesUsed(), 32u + 3u + 8u + 150u + 1000u);
+
+    arena.reset();
+    EXPECT_EQ(arena.bytesUsed(), 0u);
+    EXPECT_EQ(arena.bytesReserved(), 256u);
+}
+
+// Test cell indexing: exterior floor and walls get no index
+TEST(LayoutTest, IndexesReachableFloor) {
+    Board board = makeBoard({"XXXXX  ",
+                             "X@O.X .",
+                             "X..gX  ",
+                             "XXXXX  "});
+    Layout layout(board);
+
+    EXPECT_EQ(layout.cellCount(), 6u);
+    EXPECT_EQ(layout.cellAt(0, 0), Layout::None);
+    EXPECT_EQ(layout.cellAt(6, 1), Layout::None); // Outside the walls
+    EXPECT_EQ(layout.cellAt(1, 1), 0u);
+    EXPECT_EQ(layout.cellAt(3, 2), 5u);
+    EXPECT_EQ(layout.goals(), (std::vector<uint32_t>{5}));
+    EXPECT_EQ(layout.neighbor(0, Direction::RIGHT), 1u);
+    EXPECT_EQ(layout.neighbor(0, Direction::UP), Layout::None);
+    EXPECT_EQ(layout.neighbor(0, Direction::DOWN), 3u);
+}
+
+// Test encode/decode and player normalization
+TEST(LayoutTest, EncodeDecode) {
+    Board board = makeBoard({"XXXXXX",
+                             "X..O@X",
+                             "X.gg.X",
+                             "X..O.X",
+                             "XXXXXX"});
+    Layout layout(board);
+    std::vector<uint8_t> boxes(layout.boxBytes());
+    uint32_t player = 0;
+    ASSERT_TRUE(layout.encode(board, player, boxes.data()));
+    EXPECT_EQ(player, layout.cellAt(4, 1));
+    EXPECT_TRUE(Layout::hasBox(boxes.data(), layout.cellAt(3, 1)));
+    EXPECT_TRUE(Layout::hasBox(boxes.data(), layout.cellAt(3, 3)));
+    EXPECT_FALSE(Layout::hasBox(boxes.data(), layout.cellAt(2, 2)));
+
+    // The player can walk around the box to the top-left cell
+    EXPECT_EQ(layout.normalizePlayer(player, boxes.data()), 0u);
+
+    // Move a box and write the state back
+    Layout::clearBox(boxes.data(), layout.cellAt(3, 3));
+    Layout::setBox(boxes.data(), layout.cellAt(2, 2));
+    layout.decode(layout.cellAt(1, 1), boxes.data(), board);
+    EXPECT_EQ(board[2][2], Type::Floor | Type::Goal | Type::Box);
+    EXPECT_EQ(board[3][3], Type::Floor);
+    EXPECT_EQ(board[1][1], Type::Floor | Type::At);
+    EXPECT_EQ(board[1][4], Type::Floor);
+}
+
+// Test node storage round trip and the per-node footprint
+TEST(NodeStoreTest, AddAndRead) {
+    // A 14x14 room: 144 floor cells, 18 bytes of box bits
+    std::vector<std::string> rows(14, "X............X");
+    rows.front() = rows.back() = std::string(14, 'X');
+    rows[1][1] = '@';
+    Board board = makeBoard(rows);
+    Layout layout(board);
+    ASSERT_EQ(layout.cellCount(), 144u);
+
+    NodeStore store(layout, 1000);
+    EXPECT_LE(store.nodeBytes(), 32u);
+
+    std::vector<uint8_t> boxes(layout.boxBytes());
+    const uint32_t count = 100000;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::fill(boxes.begin(), boxes.end(), 0);
+        Layout::setBox(boxes.data(), i % 144);
+        uint32_t parent = i == 0 ? NodeStore::NoParent : i - 1;
+        EXPECT_EQ(store.add(parent, i % 144, i & 3, boxes.data()), i);
+    }
+    EXPECT_EQ(store.size(), count);
+
+    for (uint32_t i : {0u, 1u, 999u, 1000u, 54321u, count - 1}) {
+        EXPECT_EQ(store.parent(i), i == 0 ? NodeStore::NoParent : i - 1);
+        EXPECT_EQ(store.player(i), i % 144);
+        EXPECT_EQ(store.move(i), i & 3);
+        EXPECT_TRUE(Layout::hasBox(store.boxes(i), i % 144));
+        EXPECT_FALSE(Layout::hasBox(store.boxes(i), (i + 1) % 144));
+    }
+
+    // Arena overhead stays within one chunk of the raw node bytes
+    EXPECT_LE(store.bytesReserved(),
+              (count + 1000) * store.nodeBytes() + 1000);
+
+    store.clear();
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_EQ(store.add(NodeStore::NoParent, 7, 0, boxes.data()), 0u);
+    EXPECT_EQ(store.player(0), 7u);
+}
@@ -0,0 +1,194 @@
+#include "game.hpp"
+#include "load_client.hpp"
+#include "server.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Test fixture running a Server on a Unix socket in a background thread
+class ServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Game's built-in 5x5 level: player (1,1), box (2,2), goal (3,3)
+        Game(level).initialize();
+        path = "server_test_" + std::to_string(getpid()) + ".sock";
+        server = std::make_unique<Server>(level);
+        ASSERT_TRUE(server->listenUnix(path));
+        // Real accepts unless a test asks for descriptor exhaustion
+        server->setAcceptHook([this](int fd) {
+            if (exhausted) {
+                failedAccepts++;
+                errno = EMFILE;
+                return -1;
+            }
+            return accept4(fd, nullptr, nullptr,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+        });
+        loop = std::thread(&Server::run, server.get());
+    }
+
+    void TearDown() override {
+        server->stop();
+        loop.join();
+        server.reset();
+    }
+
+    int connectClient() {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr *>(&addr),
+                          sizeof(addr)),
+                  0);
+        return fd;
+    }
+
+    // Sends requests in one write and reads exactly `expect` answer bytes
+    std::vector<uint8_t> roundTrip(int fd, std::vector<uint8_t> requests,
+                                   size_t expect) {
+        EXPECT_EQ(write(fd, requests.data(), requests.size()),
+                  static_cast<ssize_t>(requests.size()));
+        std::vector<uint8_t> answers(expect);
+        size_t got = 0;
+        while (got < expect) {
+            ssize_t n = read(fd, answers.data() + got, expect - got);
+            if (n <= 0)
+                break;
+            got += n;
+        }
+        answers.resize(got);
+        return answers;
+    }
+
+    Board level;
+    std::string path;
+    std::unique_ptr<Server> server;
+    std::thread loop;
+    std::atomic<bool> exhausted{false};
+    std::atomic<size_t> failedAccepts{0};
+};
+
+// Test a session solving the built-in level over the wire
+TEST_F(ServerTest, PlaysMoves) {
+    int fd = connectClient();
+    const uint8_t down = 1, left = 2, right = 3;
+
+    // Right, push the box down, walk around it and push it right onto the
+    // goal; then an unknown request
+    std::vector<uint8_t> answers =
+        roundTrip(fd, {right, down, left, down, down, right, 0x42}, 7);
+    using namespace Protocol;
+    ASSERT_EQ(answers.size(), 7u);
+    EXPECT_EQ(answers[0], Moved);
+    EXPECT_EQ(answers[1], Moved | Pushed);
+    EXPECT_EQ(answers[2], Moved);
+    EXPECT_EQ(answers[3], Moved);
+    EXPECT_EQ(answers[4], 0); // Bottom wall
+    EXPECT_EQ(answers[5], Moved | Pushed | Complete);
+    EXPECT_EQ(answers[6], Invalid);
+
+    // Reset restores the level for this session only
+    EXPECT_EQ(roundTrip(fd, {Reset}, 1), (std::vector<uint8_t>{0}));
+    close(fd);
+}
+
+// Test the board snapshot answer
+TEST_F(ServerTest, StateSnapshot) {
+    int fd = connectClient();
+    std::vector<uint8_t> answer = roundTrip(fd, {Protocol::State}, 4 + 25);
+    ASSERT_EQ(answer.size(), 29u);
+    EXPECT_EQ(answer[0], 5);
+    EXPECT_EQ(answer[1], 0);
+    EXPECT_EQ(answer[2], 5);
+    EXPECT_EQ(answer[3], 0);
+    EXPECT_EQ(answer[4 + 1 * 5 + 1], Type::Floor | Type::At);
+    EXPECT_EQ(answer[4 + 2 * 5 + 2], Type::Floor | Type::Box);
+    close(fd);
+}
+
+// Test that a flood of State requests is answered in full while the
+// server only reads as many as it has room to answer
+TEST_F(ServerTest, StateFlood) {
+    int fd = connectClient();
+    const size_t requests = 8192;
+    std::thread writer([&] {
+        std::vector<uint8_t> flood(requests, Protocol::State);
+        size_t sent = 0;
+        while (sent < flood.size()) {
+            ssize_t n = write(fd, flood.data() + sent, flood.size() - sent);
+            if (n <= 0)
+                break;
+            sent += n;
+        }
+    });
+
+    std::vector<uint8_t> answers(requests * 29);
+    size_t got = 0;
+    while (got < answers.size()) {
+        ssize_t n = read(fd, answers.data() + got, answers.size() - got);
+        if (n <= 0)
+            break;
+        got += n;
+    }
+    writer.join();
+    ASSERT_EQ(got, answers.size());
+    for (size_t i = 0; i < requests; ++i) {
+        EXPECT_EQ(answers[i * 29], 5);
+        EXPECT_EQ(answers[i * 29 + 2], 5);
+    }
+    close(fd);
+}
+
+// Test that running out of descriptors pauses accepting until a session
+// leaves, and that the waiting client is served then
+TEST_F(ServerTest, DescriptorExhaustion) {
+    int first = connectClient();
+    ASSERT_EQ(roundTrip(first, {Protocol::Reset}, 1).size(), 1u);
+
+    exhausted = true;
+    int second = connectClient();
+    while (failedAccepts == 0) {
+        std::this_thread::yield();
+    }
+    exhausted = false;
+
+    // The listener is no longer watched, so descriptors being available
+    // again does not get the waiting client accepted...
+    const uint8_t reset = Protocol::Reset;
+    ASSERT_EQ(write(second, &reset, 1), 1);
+    struct pollfd pfd = {second, POLLIN, 0};
+    EXPECT_EQ(poll(&pfd, 1, 100), 0);
+    EXPECT_EQ(failedAccepts, 1u);
+    EXPECT_EQ(server->sessionCount(), 1u);
+
+    // ...until a session closes and re-arms it
+    close(first);
+    ASSERT_EQ(poll(&pfd, 1, 5000), 1);
+    uint8_t answer = 0xEE;
+    EXPECT_EQ(read(second, &answer, 1), 1);
+    EXPECT_EQ(answer, 0);
+    close(second);
+}
+
+// Test many concurrent sessions through the bundled load generator
+TEST_F(ServerTest, LoadGenerator) {
+    LoadConfig config;
+    config.unixPath = path;
+    config.sessions = 200;
+    config.requestsPerSession = 500;
+    config.pipeline = 32;
+
+    LoadResult result = runLoad(config);
+    EXPECT_EQ(result.connected, 200u);
+    EXPECT_EQ(result.answered, 200u * 500u);
+    EXPECT_EQ(result.invalid, 0u);
+}
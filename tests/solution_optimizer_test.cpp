@@ -0,0 +1,74 @@
+#include "solution_optimizer.hpp"
+#include "test_boards.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+const std::vector<std::string> TwoRows = {"XXXXXXXX",
+                                          "X..O.g.X",
+                                          "X@.....X",
+                                          "X..O.g.X",
+                                          "XXXXXXXX"};
+} // namespace
+
+// Test reading the pushes back out of a LURD string
+TEST(SolutionOptimizerTest, LurdToPushes) {
+    Board level = makeBoard(TwoRows);
+    Layout layout(level);
+    std::vector<uint8_t> boxes(layout.boxBytes());
+    uint32_t player;
+    ASSERT_TRUE(layout.encode(level, player, boxes.data()));
+
+    std::vector<Push> pushes;
+    ASSERT_TRUE(lurdToPushes(layout, player, boxes, "urRdldR", pushes));
+    ASSERT_EQ(pushes.size(), 2u);
+    EXPECT_EQ(pushes[0].box, layout.cellAt(3, 1));
+    EXPECT_EQ(pushes[0].dir, Direction::RIGHT);
+    EXPECT_EQ(pushes[1].box, layout.cellAt(3, 3));
+
+    EXPECT_FALSE(lurdToPushes(layout, player, boxes, "l", pushes));
+    EXPECT_FALSE(lurdToPushes(layout, player, boxes, "x", pushes));
+}
+
+// Test that detours between pushes are cut
+TEST(SolutionOptimizerTest, ShortensWalks) {
+    Board level = makeBoard({"XXXXXXX", "X@.O.gX", "XXXXXXX"});
+    OptimizeResult result =
+        optimizeSolution(level, "rlrlrRR", OptimizerConfig());
+    EXPECT_TRUE(result.valid);
+    EXPECT_EQ(result.solution, "rRR");
+    EXPECT_EQ(result.before.moves, 7u);
+    EXPECT_EQ(result.after.moves, 3u);
+    EXPECT_EQ(result.after.pushes, 2u);
+}
+
+// Test that interleaved pushes are reordered to save walking
+TEST(SolutionOptimizerTest, ReordersPushes) {
+    Board level = makeBoard(TwoRows);
+    const std::string zigzag = "urRdldRuuRdldR";
+    OptimizerConfig config;
+    config.threads = 2;
+    OptimizeResult result = optimizeSolution(level, zigzag, config);
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.before.moves, 14u);
+    EXPECT_EQ(result.after.moves, 10u);
+    EXPECT_EQ(result.after.pushes, 4u);
+    EXPECT_GE(result.improved, 1u);
+    EXPECT_TRUE(verifySolution(level, result.solution).solved);
+
+    // Windows of two pushes cannot reorder across the boxes, but the
+    // result is never worse
+    config.window = 2;
+    result = optimizeSolution(level, zigzag, config);
+    EXPECT_TRUE(verifySolution(level, result.solution).solved);
+    EXPECT_LE(result.after.moves, 14u);
+}
+
+// Test that a solution that does not solve the level comes back as is
+TEST(SolutionOptimizerTest, RejectsInvalid) {
+    Board level = makeBoard(TwoRows);
+    OptimizeResult result = optimizeSolution(level, "urR", OptimizerConfig());
+    EXPECT_FALSE(result.valid);
+    EXPECT_EQ(result.solution, "urR");
+}
@@ -0,0 +1,53 @@
+#include "solution.hpp"
+#include "test_boards.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Test LURD replay through Game's move rules
+TEST(SolutionTest, Verify) {
+    Board level = makeBoard({"XXXXXX",
+                             "X@.OgX",
+                             "X....X",
+                             "XXXXXX"});
+    SolutionCheck check = verifySolution(level, "rR");
+    EXPECT_TRUE(check.solved);
+    EXPECT_EQ(check.moves, 2u);
+    EXPECT_EQ(check.pushes, 1u);
+
+    EXPECT_FALSE(verifySolution(level, "rr").solved);  // Case lies
+    EXPECT_FALSE(verifySolution(level, "r").solved);   // Not finished
+    EXPECT_FALSE(verifySolution(level, "u").solved);   // Into a wall
+    EXPECT_FALSE(verifySolution(level, "rRx").solved); // Not a move
+    EXPECT_TRUE(verifySolution(level, "drulrR").solved);
+}
+
+// Test expanding pushes into a walk-and-push string
+TEST(SolutionTest, PushesToLurd) {
+    Board level = makeBoard({"XXXXXX",
+                             "X@...X",
+                             "X.O..X",
+                             "X....X",
+                             "X...gX",
+                             "XXXXXX"});
+    Layout layout(level);
+    std::vector<uint8_t> boxes(layout.boxBytes());
+    uint32_t player = 0;
+    ASSERT_TRUE(layout.encode(level, player, boxes.data()));
+
+    // Right twice, then around the box and down twice
+    std::vector<Push> pushes = {{layout.cellAt(2, 2), Direction::RIGHT},
+                                {layout.cellAt(3, 2), Direction::RIGHT},
+                                {layout.cellAt(4, 2), Direction::DOWN},
+                                {layout.cellAt(4, 3), Direction::DOWN}};
+    std::string lurd;
+    ASSERT_TRUE(pushesToLurd(layout, player, boxes, pushes, lurd));
+    EXPECT_EQ(lurd, "dRRurDD");
+    EXPECT_TRUE(verifySolution(level, lurd).solved);
+
+    // Nobody can stand behind a box against the wall
+    pushes = {{layout.cellAt(2, 2), Direction::RIGHT},
+              {layout.cellAt(3, 2), Direction::RIGHT},
+              {layout.cellAt(4, 2), Direction::LEFT}};
+    EXPECT_FALSE(pushesToLurd(layout, player, boxes, pushes, lurd));
+}
@@ -0,0 +1,194 @@
+#include "batch_solver.hpp"
+#include "solution.hpp"
+#include "solver.hpp"
+#include "test_boards.hpp"
+#include <cmath>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+const std::vector<std::string> TwoBoxes = {"XXXXXXXX",
+                                           "X..g...X",
+                                           "X.OXO..X",
+                                           "X@.g...X",
+                                           "XXXXXXXX"};
+const std::vector<std::string> OnePush = {"XXXXXX", "X@O.gX", "XXXXXX"};
+const std::vector<std::string> Stuck = {"XXXXXXX", "X@OOggX", "XXXXXXX"};
+} // namespace
+
+// Test the push distance lower bound
+TEST(SolverTest, PushDistances) {
+    Board level = makeBoard(OnePush);
+    Layout layout(level);
+    PushDistances distances(layout);
+    EXPECT_EQ(distances.toNearestGoal(layout.cellAt(4, 1)), 0);
+    EXPECT_EQ(distances.toNearestGoal(layout.cellAt(2, 1)), 2);
+    // The box could never be pushed off the left wall
+    EXPECT_EQ(distances.toNearestGoal(layout.cellAt(1, 1)),
+              PushDistances::Unreachable);
+
+    std::vector<uint8_t> boxes(layout.boxBytes());
+    uint32_t player;
+    ASSERT_TRUE(layout.encode(level, player, boxes.data()));
+    EXPECT_EQ(distances.lowerBound(boxes.data()), 2u);
+}
+
+// Test push-optimal solutions that replay correctly
+TEST(SolverTest, Solves) {
+    SolverResult one = solve(makeBoard(OnePush), SolverLimits());
+    EXPECT_EQ(one.status, SolveStatus::SOLVED);
+    EXPECT_EQ(one.solution, "RR");
+    EXPECT_EQ(one.pushes, 2u);
+
+    Board level = makeBoard(TwoBoxes);
+    SolverResult two = solve(level, SolverLimits());
+    ASSERT_EQ(two.status, SolveStatus::SOLVED);
+    SolutionCheck check = verifySolution(level, two.solution);
+    EXPECT_TRUE(check.solved);
+    EXPECT_EQ(check.moves, two.moves);
+    EXPECT_EQ(check.pushes, two.pushes);
+    EXPECT_GT(two.nodes, 1u);
+}
+
+// Test dead ends, invalid levels and exhausted budgets
+TEST(SolverTest, Failures) {
+    EXPECT_EQ(solve(makeBoard(Stuck), SolverLimits()).status,
+              SolveStatus::UNSOLVABLE);
+    EXPECT_EQ(solve(makeBoard({"XXXXX", "X.O.X", "XXXXX"}), SolverLimits())
+                  .status,
+              SolveStatus::INVALID);
+
+    SolverLimits tiny;
+    tiny.memoryBytes = 1;
+    const std::vector<std::string> open = {"XXXXXXXXX",
+                                           "X.......X",
+                                           "X.O.O.O.X",
+                                           "X...@...X",
+                                           "X.O.O.O.X",
+                                           "Xgggggg.X",
+                                           "XXXXXXXXX"};
+    EXPECT_EQ(solve(makeBoard(open), tiny).status,
+              SolveStatus::OUT_OF_MEMORY);
+
+    SolverLimits instant;
+    instant.time = std::chrono::milliseconds(0);
+    EXPECT_EQ(solve(makeBoard(open), instant).status, SolveStatus::TIME_OUT);
+}
+
+// Test that the difficulty score orders levels sensibly
+TEST(SolverTest, Difficulty) {
+    EXPECT_LT(estimateDifficulty(makeBoard(OnePush)),
+              estimateDifficulty(makeBoard(TwoBoxes)));
+    EXPECT_TRUE(std::isinf(
+        estimateDifficulty(makeBoard({"XXXXX", "X.O.X", "XXXXX"}))));
+}
+
+// Test fixture writing a small pack to a scratch directory
+class BatchSolverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = "solver_test_" + std::to_string(getpid());
+        std::filesystem::create_directories(dir);
+        const std::vector<std::vector<std::string>> levels = {
+            TwoBoxes, Stuck, OnePush};
+        for (size_t i = 0; i < levels.size(); ++i) {
+            files.push_back(dir + "/level" + std::to_string(i));
+            ASSERT_TRUE(makeBoard(levels[i]).saveToFile(files.back()));
+        }
+        files.push_back(dir + "/missing");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    std::string dir;
+    std::vector<std::string> files;
+};
+
+// Test easiest-first reporting and per-level outcomes
+TEST_F(BatchSolverTest, SolvesPack) {
+    BatchConfig config;
+    config.threads = 1;
+    std::vector<size_t> order;
+    std::vector<BatchResult> results = BatchSolver(config).run(
+        files, [&](const BatchResult &r) { order.push_back(r.index); });
+
+    ASSERT_EQ(results.size(), 4u);
+    // The unreadable file is reported up front, then easiest first
+    EXPECT_EQ(order, (std::vector<size_t>{3, 2, 1, 0}));
+    EXPECT_EQ(results[0].result.status, SolveStatus::SOLVED);
+    EXPECT_EQ(results[1].result.status, SolveStatus::UNSOLVABLE);
+    EXPECT_EQ(results[2].result.solution, "RR");
+    EXPECT_EQ(results[3].result.status, SolveStatus::INVALID);
+    EXPECT_EQ(results[3].attempts, 0u);
+    EXPECT_EQ(results[0].file, files[0]);
+}
+
+// Test that a level out of budget is retried with a bigger one
+TEST_F(BatchSolverTest, Retries) {
+    BatchConfig config;
+    config.threads = 4;
+    config.limits.memoryBytes = 1;
+    config.attempts = 3;
+    config.growth = 1 << 16;
+    std::vector<BatchResult> results = BatchSolver(config).run(files);
+
+    // 1 byte, then 64 KiB (less than one node chunk), then plenty
+    EXPECT_EQ(results[0].result.status, SolveStatus::SOLVED);
+    EXPECT_EQ(results[0].attempts, 3u);
+    EXPECT_EQ(results[1].result.status, SolveStatus::UNSOLVABLE);
+    EXPECT_EQ(results[3].attempts, 0u);
+
+    config.attempts = 1;
+    results = BatchSolver(config).run(files);
+    EXPECT_EQ(results[0].result.status, SolveStatus::OUT_OF_MEMORY);
+    EXPECT_EQ(results[0].attempts, 1u);
+}
+
+// Test the CSV and JSON Lines reports
+TEST(ReportWriterTest, Formats) {
+    BatchResult r;
+    r.index = 7;
+    r.file = "a,\"b\"";
+    r.difficulty = 1.5;
+    r.attempts = 2;
+    r.result.status = SolveStatus::SOLVED;
+    r.result.solution = "rR";
+    r.result.moves = 2;
+    r.result.pushes = 1;
+    r.result.nodes = 3;
+
+    std::ostringstream csv;
+    ReportWriter csvWriter(csv, ReportFormat::CSV);
+    csvWriter.write(r);
+    csvWriter.write(r);
+    EXPECT_EQ(csv.str(),
+              "index,file,status,moves,pushes,nodes,seconds,attempts,"
+              "difficulty,solution\n"
+              "7,\"a,\"\"b\"\"\",solved,2,1,3,0.000,2,1.50,rR\n"
+              "7,\"a,\"\"b\"\"\",solved,2,1,3,0.000,2,1.50,rR\n");
+
+    std::ostringstream json;
+    ReportWriter(json, ReportFormat::JSON).write(r);
+    EXPECT_EQ(json.str(),
+              "{\"index\":7,\"file\":\"a,\\\"b\\\"\",\"status\":\"solved\","
+              "\"moves\":2,\"pushes\":1,\"nodes\":3,\"seconds\":0.000,"
+              "\"attempts\":2,\"difficulty\":1.50,\"solution\":\"rR\"}\n");
+
+    // An unscored level leaves the CSV field empty and is null in JSON
+    r.difficulty = std::numeric_limits<double>::infinity();
+    r.result = SolverResult();
+    r.result.status = SolveStatus::INVALID;
+    std::ostringstream unscored;
+    ReportWriter unscoredCsv(unscored, ReportFormat::CSV);
+    unscoredCsv.write(r);
+    EXPECT_NE(unscored.str().find(",2,,\n"), std::string::npos);
+    std::ostringstream unscoredJson;
+    ReportWriter(unscoredJson, ReportFormat::JSON).write(r);
+    EXPECT_NE(unscoredJson.str().find("\"difficulty\":null"),
+              std::string::npos);
+}
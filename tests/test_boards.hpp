@@ -0,0 +1,63 @@
+#ifndef TEST_BOARDS_H_9b47c15f853c5a1d
+#define TEST_BOARDS_H_9b47c15f853c5a1d
+
+#include "board.hpp"
+#include <string>
+#include <vector>
+
+// Fills board from rows of the characters Type::toChar prints:
+// X wall, . floor, g goal, O box, * box on goal, @ player, + player on
+// goal, space empty
+inline void fillBoard(Board &board, const std::vector<std::string> &rows) {
+    board.resize(rows.empty() ? 0 : rows[0].size(), rows.size());
+    for (size_t y = 0; y < rows.size(); ++y) {
+        for (size_t x = 0; x < rows[y].size(); ++x) {
+            Flag f = Type::Empty;
+            switch (rows[y][x]) {
+            case 'X':
+                f = Type::Wall;
+                break;
+            case '.':
+                f = Type::Floor;
+                break;
+            case 'g':
+                f = Type::Floor | Type::Goal;
+                break;
+            case 'O':
+                f = Type::Floor | Type::Box;
+                break;
+            case '*':
+                f = Type::Floor | Type::Box | Type::Goal;
+                break;
+            case '@':
+                f = Type::Floor | Type::At;
+                break;
+            case '+':
+                f = Type::Floor | Type::At | Type::Goal;
+                break;
+            }
+            board[y][x] = f;
+        }
+    }
+}
+
+inline Board makeBoard(const std::vector<std::string> &rows) {
+    Board board;
+    fillBoard(board, rows);
+    return board;
+}
+
+// The rows back, as Board::print would show them
+inline std::vector<std::string> boardRows(const Board &board) {
+    std::vector<std::string> rows;
+    for (size_t y = 0; y < board.height(); ++y) {
+        std::string row;
+        for (size_t x = 0; x < board.width(); ++x) {
+            row += Type::toChar(board[y][x]);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+#endif // TEST_BOARDS_H_9b47c15f853c5a1d